@@ -9,14 +9,22 @@
  * TO DO:1) seqInSlot for writing sequences 1 element at a time, and associated initSeqSlot, with addition of seq.filled copying in scramble
  * TO DO:2) moveInSlot and associated sequence re-writing function
  * TO DO:3) it would be nice to be able to toggle between tuple and linear phase sequence by performing some sort of quantize of a linear seq
+ *          - done: onsetsInSlot / quantize
  * TO DO:4) Scramble groups, and also scramble an individual group or internal sequences of groups
- * TO DO:5) Insert group
- *       6) Nested subgroup e.g. make a 3 inside a 5:
+ *       5) Insert group - done: insertGroup / deleteGroup
+ *       6) Nested subgroup e.g. make a 3 inside a 5 - done: nest / unnest
  * 20 30 30 30 20 20   |      |    |    |    |      |      |
  * 16ths               |        |        |        |        |
  * ...easy to work out (7.5th or 2x15th) but the ability to command "split two 5ths into 3" is...just bump the sequence down one, change one entry and create a new entry after it (into the "duplication")...or just write the whole sequence (and groups) from the change to the end!
  */
 
+/* creation flags
+ * -sig  --- adds 16 signal outlets after durAlt: p1 e1 p2 e2 ... p8 e8, held for each event and
+ *           switched on the sample where the event starts
+ * -mc [N] --- (Pd 0.54+) one multichannel signal outlet instead: ramp, alt ramp, offset, p1..pN
+ *           (N = 0 to 8, default 8); -sig is ignored
+ */
+
 /* data types
  * full sequences:
  * dType --- dataOut
@@ -24,8 +32,8 @@
  * 1     --- eSize: {sizePhase[0], sizePhase[1], sizePhase[2] ... sizePhase[len-1]}
  * 2     --- groupStep: {gStep[0], gStep[1], gStep[2] ... gStep[len-1]}
  * 3     --- groupNum:  {gNum[0], gNum[1], gNum[2] ... gNum[len-1]}
- * 4     --- eJoin (is the event joined to the next event) - not fully implemented yet
- * 5     --- jSize (length of the join - this could be eliminated if eJoin was jSize)
+ * 4     --- eJoin (join overlay: N at the first event of a run of N events sounding as one)
+ * 5     --- jSize (phase length of the whole run at its first event, 0 inside it - resolved from eJoin)
  *
  * 11    --- pAcc1 array
  * 12    --- eAcc1 array
@@ -44,13 +52,16 @@
  * 25    --- pAcc8 array
  * 26    --- eAcc8 array
  * group values:
+ * 88    --- lookahead {k, slot, variation, step, time (ms), duration (ms), duration (samples), p1, e1 ... p8, e8}
+ * 89    --- scrambled {slot, variation, success} - a background scramble has been published
+ * 90    --- changed {slot, variation, dType, start, end} - see notifyChanges / getChanges
  * 91    --- {gType, nGroups, cycles, len, remains, 0}
  * 92    --- group numerators
  * 93    --- group denominators
  * 94    --- group offsets (phase)
  * 95    --- group size in phase
  * 96    --- group start (events)
- * 97    --- 
+ * 97    --- page header {slot, variation, dType, start, count, length} - precedes each paged/streamed list
  *       --- 
  * 98    --- {slot, length}
  * 99    --- {slot, variation}
@@ -68,7 +79,11 @@
 #endif
 
 #include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
 #include <time.h>
+#include <pthread.h>
 
 #include "m_pd.h" 
 
@@ -76,12 +91,9 @@
 
 static t_class *polyMath_tilde_class;
 
-typedef struct drand48_data *randomize;
-
 typedef struct _groups
 {
-  t_int gType[SLOTS];                // NEW (and as yet undefined at 1 Dec 2018) tuples (gType = 0) or
-                                     // linear phase (gType = 1)
+  t_int gType[SLOTS];                // tuples (gType = 0) or linear phase (gType = 1, see onsetsInSlot)
   t_int nGroups[SLOTS];              // number of groups in this sequence
   t_int gStart[GROUPS * SLOTS];      // where in the sequence does each group start?
   t_atom n[GROUPS * SLOTS];          // numerator of the time sig (fraction)
@@ -117,6 +129,10 @@ typedef struct _vars
   t_int swapsRef[MAXSEQ * 2];
   t_int swapped[MAXSEQ];
   t_int groupSwaps[GROUPS];
+  t_int blockStart[MAXSEQ];   // scrambleSwaps: each join run (or group) is one block
+  t_int blockLen[MAXSEQ];
+  t_int blockPick[MAXSEQ];    // partial Fisher-Yates: the first k entries are the displaced blocks
+  t_int blockOrder[MAXSEQ];   // block that ends up at each block position
 
 } t_vars;                
 
@@ -164,6 +180,7 @@ typedef struct _variations
   t_atom pAcc6[MAXSEQ * SLOTS * VARIATIONS];     // accent or parameter storage for event
   t_atom pAcc7[MAXSEQ * SLOTS * VARIATIONS];     // accent or parameter storage for event
   t_atom pAcc8[MAXSEQ * SLOTS * VARIATIONS];     // accent or parameter storage for event
+  t_int jRun[MAXSEQ * SLOTS * VARIATIONS];       // joins resolved for playback: run length at a run start, -1 inside a run
 
 } t_variations;
 
@@ -210,12 +227,79 @@ typedef struct _sequences
   t_atom pAcc6[MAXSEQ * SLOTS];     // accent or parameter storage for event
   t_atom pAcc7[MAXSEQ * SLOTS];     // accent or parameter storage for event
   t_atom pAcc8[MAXSEQ * SLOTS];     // accent or parameter storage for event
+  t_int jRun[MAXSEQ * SLOTS];       // joins resolved for playback: run length at a run start, -1 inside a run
   t_atom pList5[2];
   t_atom pList6[2];
   t_atom pList7[2];
   t_atom pList8[2];
 
-} t_sequences;                      
+} t_sequences;
+
+/* background scramble: the base slot is copied into src on Pd's thread, the worker builds the variation
+ * into dst and the group arrays, and Pd's thread copies the result into var / vGrp (see buildOut)
+ * fields: 0 allStep, 1 varStep, 2 groupStep, 3 groupNum, 4 eSize, 5 eOff, 6 eJoin, 7 jSize, 8 eSizeInv,
+ * 9 denom, 10-17 pAcc1-8, 18-25 eAcc1-8, 26 varOff, 27 grpOff (26 and 27 are built, never copied in)
+ */
+#define BUILDFIELDS 28
+#define SRCFIELDS 26
+#define SCRAMQUEUE (SLOTS * VARIATIONS)
+#define BUILD_IDLE 0
+#define BUILD_REQUESTED 1
+#define BUILD_DONE 2
+
+typedef struct _varBuild
+{
+  t_int slot, var, len, cycles, nGroups, doSwaps, state, well;
+  t_int swapsRef[MAXSEQ * 2];
+  t_atom src[SRCFIELDS * MAXSEQ];
+  t_atom dst[BUILDFIELDS * MAXSEQ];
+  t_int gStart[GROUPS];
+  t_atom n[GROUPS];
+  t_atom d[GROUPS];
+  t_atom offset[GROUPS];
+  t_atom size[GROUPS];
+  t_atom sizeInv[GROUPS];
+} t_varBuild;
+
+/* variation pool: per slot, any number of variations stored compactly (t_float, exactly len long)
+ * pool entry k is variation VARIATIONS + 1 + k. To be played an entry is copied into one of the two
+ * top fixed variations (VARIATIONS - 1 and VARIATIONS, alternately), so those are the staging area for
+ * any slot that has a pool. Staging refuses a variation that holds a sequence of its own.
+ */
+typedef struct _poolVar
+{
+  t_int len, cycles, nGroups;
+  t_float *data;   // BUILDFIELDS * len, field by field
+  t_int *gStart;   // nGroups
+  t_float *grp;    // 5 * nGroups: n, d, offset, size, sizeInv
+} t_poolVar;                      
+
+/* nested subgroups: per slot, a tree of tuplets over the flat groups. A root node is one group of the slot
+ * (n steps over the group size); a child replaces span steps of its parent, starting at step at, with n
+ * equal steps. Nodes are kept in one array per slot and linked by index (-1 = none), children sorted by at.
+ */
+typedef struct _nestNode
+{
+  t_int used;
+  t_int group;     // root: the group of the slot, -1 for a child
+  t_int n;         // steps
+  t_int at, span;  // child: the steps of the parent it replaces
+  t_int child, next;
+} t_nestNode;
+
+/* undo: one record is the old values of a range of events of one sequence, for the fields in mask (the
+ * EVENTLIST fields in eventList order, then varStep for variations). whole = the record is the full
+ * sequence from start, whatever its length. The records of one edit share a step number.
+ */
+#define UNDORECORDS 1024
+#define UNDOFIELDS 28
+#define UNDO_ALL 0xfffffff
+
+typedef struct _undoRec
+{
+  t_int step, slot, var, start, count, whole, len, variations, mask;
+  t_atom *data;    // count * the fields in mask, field by field
+} t_undoRec;
 
 typedef struct _polyMath_tilde
 {
@@ -234,7 +318,8 @@ typedef struct _polyMath_tilde
   t_atom eventList[EVENTLIST];
   t_atom dList[2]; // next duration / phase
   
-  unsigned short int seed16v[3];
+  uint32_t rng[4];            // per-instance xoshiro128** state for scrambles - see polyMath_tilde_seed
+  uint32_t playRng[4];        // a second state for playback (morph, generate), seeded with rng
   unsigned long int timeSeed;
 
   //rounder
@@ -258,9 +343,9 @@ typedef struct _polyMath_tilde
   //leftovers, perform and joins:
   t_int barNew, join, Joined, myBug, pJoin, PJoined, JoinVal, Jointot, j, k, RW, l, m;
   t_int slot, Wstep, Icycle, Gstp, GroupStart, PSlot, JGstt, JGnm;
-  t_int jFlag, jFirst, joinSuccess, sortFlag; // FLAGS
+  t_int jFlag, jFirst, sortFlag; // FLAGS
   t_int JSlot, JGrp, JLoc, JLen, JBuf, JGst, initSlot;
-  // care must be taken to reset jFlag and jFirst when entering new slot, or writing groups! 30/10/2017
+  // jFlag and jFirst are set per step by checkJoinsOut from the join cache, no state carries over
   t_float PESize, PEOff, PESInv, JPESI, group, JGSize, JESize, JJoin, JGn, JGd, JGt;
   t_int maxGrp, fGroup;
   //aternate signal outs for event seg~
@@ -306,6 +391,79 @@ typedef struct _polyMath_tilde
   t_int getSlot, getVar, getPar, v, getVarNum;
   t_int grpOff, seqOff, seqGrpOff, lenSeq, lenGrp;
   t_float getSeqVal, getGrpVal;
+  //paged and streamed getSequence
+  t_int dumpSlot, dumpVar, dumpPar, dumpStart, dumpPage, dumpLen;
+  t_atom dumpHead[6];
+  //change log - one dirty range and a dType bitmask per slot / variation (variation 0 = the slot itself)
+  t_int dirtyStart[SLOTS * (VARIATIONS + 1)];
+  t_int dirtyEnd[SLOTS * (VARIATIONS + 1)];
+  t_int dirtyFields[SLOTS * (VARIATIONS + 1)];
+  t_int dirtyList[SLOTS * (VARIATIONS + 1)];
+  t_int dirtyCount, notifyChanges;
+  //transactions
+  t_int txOpen, txApplying, txLen, txSize;
+  t_int txQueued;                         // edits queued since begin
+  t_int txRegroups;                       // entries in txList while end applies them
+  t_atom *txBuf;                          // queued edits: selector, argc, args...
+  t_int txFrom[SLOTS * (VARIATIONS + 1)]; // regroup needed from / to, -1 = none
+  t_int txTo[SLOTS * (VARIATIONS + 1)];
+  t_int txList[SLOTS * (VARIATIONS + 1)];
+  t_atom changeList[5];
+  //look-ahead window
+  t_int lookAhead;
+  double startTime;
+  t_atom lookList[23];
+  //background scramble
+  t_varBuild *build;
+  pthread_t buildThread;
+  pthread_mutex_t buildMutex;
+  pthread_cond_t buildCond;
+  t_int buildThreadOk, buildQuit;
+  t_int scramQSlot[SCRAMQUEUE], scramQVar[SCRAMQUEUE];
+  t_float scramQProb[SCRAMQUEUE];
+  t_int scramQHead, scramQCount;
+  t_int scramQBatch[SCRAMQUEUE], buildBatch;
+  t_int scramQSrc[SCRAMQUEUE], scramQMode[SCRAMQUEUE], scramQUnit[SCRAMQUEUE];
+  t_int batchOpen, batchPending, batchDone, batchOk;
+  t_atom buildList[3];
+  //variation pool
+  t_poolVar *pool[SLOTS];
+  t_int poolSize[SLOTS];
+  t_int poolStage[SLOTS];
+  t_int poolStaged[SLOTS];    // bit 0 / 1: variation VARIATIONS-1 / VARIATIONS holds an unedited copy of a pool entry
+  //generative playback
+  t_int genMode[SLOTS];       // 0 = off, 1 = shuffle every cycle, 2 = Markov, 3 = group map
+  t_float *genTable[SLOTS];   // Markov weights, len * len (from step, to step), 0 = uniform
+  t_int genTableLen[SLOTS];
+  t_int genOrder[MAXSEQ];     // join run starts of the playing slot, in playing order for shuffle
+  t_int genSlot, genSrc, genStart, genEnd, genBlock, genBlocks;
+  t_int genCur;               // genMode of the playing slot, latched at the start of each cycle
+  t_float genBlockSize[MAXSEQ]; // phase length of the join run starting at each step, filled at the start of a cycle
+  t_float genMinSize;         // the shortest of them
+  t_float genLeft;            // phase left in the cycle after the run being played
+  t_int genFitStep;           // event whose size is cut or padded to end the cycle, -1 = none
+  t_float genFitSize, genRunSize; // its size, and the phase length of the run being played
+  t_int grpMap[GROUPS * SLOTS];      // group map: the group played at each position
+  t_float grpMapOff[GROUPS * SLOTS]; // phase offset of each position (prefix sum of the group sizes)
+  t_int grpMapN[SLOTS];
+  //morph
+  t_int morphSlot, morphVar, morphOn;
+  t_float morphAmt;
+  t_int morphMask[MAXSEQ];   // 0 = keep the sequence, 1 = may take the variation (join run start), 2 = rest of that run
+  //insertGroup / deleteGroup: lowest group and event whose offsets and numbering are stale, -1 = clean
+  t_int grpFixGroup[SLOTS], grpFixEvent[SLOTS], grpFixCount;
+  //nest / unnest
+  t_nestNode *nest[SLOTS];
+  t_int nestSize[SLOTS];
+  t_float nestEvents[MAXSEQ]; // event sizes of the group being compiled
+  //join cache: sequences (slot + var * SLOTS) whose jRun / jSize must be resolved again
+  t_int joinStale[SLOTS * (VARIATIONS + 1)], joinList[SLOTS * (VARIATIONS + 1)], joinCount;
+  t_int PJRun;
+  t_float PJSize;
+  //undo / redo: records undoHead ... undoHead + undoCount - 1 (mod UNDORECORDS), the first undoCur can be undone
+  t_undoRec undo[UNDORECORDS];
+  t_int undoHead, undoCount, undoCur, undoStep, batchStep;
+  long undoBytes, undoMax;
 
   //polyMath_tilde_seqInSlot
   t_int seqGrpOffset;
@@ -314,7 +472,7 @@ typedef struct _polyMath_tilde
   t_float seqPhase, seqPOff, prevSPhase;
 
   //polyMath_tilde_seqInSlot and swap variable
-  t_int swapSlot, swapVar, swapLoc, swapShift, x, swapLength;
+  t_int swapSlot, swapVar, swapLoc, swapShift, x, swapLength, swapEnd;
   t_float swapP, swapE;
   t_int isSwapList;
   t_int isShuffled;
@@ -332,11 +490,15 @@ typedef struct _polyMath_tilde
   //slotLen
   t_int isLength, getSlotLen;
   
-  t_clock *fOut, *early, *pageTurner;
+  t_clock *fOut, *early, *pageTurner, *seqDump, *changeOut, *buildOut, *grpFix, *joinClock, *morphClock;
   t_outlet *clock, *subclock; // from v1
   t_outlet *cycle, *newgroup, *newbar, *p1, *p2, *p3, *p4, *p5, *p6, *p7, *p8, *groupnum, *num, *denom; // from v1
   t_outlet *eventLengthPhase, *eventLengthNum, *alt, *eChange, *eAlt, *page;
   t_outlet *dataOut, *dType, *durFirst, *durAlt; // list outlets to communicate with app
+  // -sig: p1 e1 p2 e2 ... p8 e8 as sample-and-hold signals after the control outlets
+  // -mc: sigLanes = 2, one multichannel outlet of ramp, alt, offset, p1..pN (N = nLanes)
+  t_int sigLanes, nLanes;
+  t_float *sigP[8], *sigE[8];
   // new 30th Oct 2017, for joined-clock events in phase (e.g. 0.125) and num (e.g. 2x16ths) and alt versions (for priming playback subpatches)
   // new 28th November 2018, sequences output from rightmost outlet...I have yet to write any code for this (15:21PM, 28th Nov 2018)
 } t_polyMath_tilde;
@@ -351,25 +513,371 @@ t_int rounder(t_polyMath_tilde *x, t_float f, t_int limit) // limiting round fun
   return(x->iRound);
 }
 
+/* RANDOM NUMBERS
+ * xoshiro128** per instance, so that instances don't share (or disturb) one stream and a given seed
+ * gives the same scrambles on every run and machine. splitmix32 spreads the seed over the state.
+ * Playback (morph, generate) draws from its own state, so playing between scrambles does not change
+ * which variations a seed gives.
+ */
+static void seedState(uint32_t *r, uint32_t seed)
+{
+  t_int i;
+  uint32_t z;
+  for(i = 0; i < 4; i++)
+    {
+      seed += 0x9e3779b9;
+      z = seed;
+      z = (z ^ (z >> 16)) * 0x85ebca6b;
+      z = (z ^ (z >> 13)) * 0xc2b2ae35;
+      r[i] = z ^ (z >> 16);
+    }
+}
+
+static void seedRandom(t_polyMath_tilde *x, uint32_t seed)
+{
+  seedState(x->rng, seed);
+  seedState(x->playRng, seed ^ 0x5bd1e995);
+}
+
+// 0 <= r < 1
+static double nextRandom(uint32_t *r)
+{
+  uint32_t result = r[1] * 5;
+  uint32_t t = r[1] << 9;
+  result = ((result << 7) | (result >> 25)) * 9;
+  r[2] ^= r[0];
+  r[3] ^= r[1];
+  r[1] ^= r[2];
+  r[0] ^= r[3];
+  r[2] ^= t;
+  r[3] = (r[3] << 11) | (r[3] >> 21);
+  return((double)result * (1.0 / 4294967296.0));
+}
+
+static double pmRandom(t_polyMath_tilde *x)
+{
+  return(nextRandom(x->rng));
+}
+
+static double playRandom(t_polyMath_tilde *x)
+{
+  return(nextRandom(x->playRng));
+}
+
+void polyMath_tilde_seed(t_polyMath_tilde *x, t_floatarg f)
+{
+  seedRandom(x, (uint32_t)(int32_t)f);
+}
+
+/* CHANGE LOG
+ * dTypes 0-5 use bits 0-5 and dTypes 11-26 use bits 6-21 of dirtyFields, so that a scramble
+ * (all fields) and a pSet (two fields of one step) can both be logged in O(1)
+ */
+#define DIRTY_ALL 0x3fffff
+
+static t_int dirtyBit(t_int field)
+{
+  if(field < 0) return(DIRTY_ALL);
+  else if(field < 6) return(1 << field);
+  else if(field > 10 && field < 27) return(1 << (field - 5));
+  else return(0);
+}
+
+/* JOIN CACHE
+ * eJoin is the join overlay: N at the first event of a run of N, written by makeJoin / setJoins in the
+ * time of the run itself. Where runs overlap, the earlier one wins. Before playback reads a sequence the
+ * overlay is resolved into jRun (N at a run start, -1 for the events it covers, 0 = never resolved, a plain
+ * event) and jSize (the phase length of the whole run, 0 inside it), so perform looks the join up instead of
+ * counting runs down.
+ */
+static void joinMark(t_polyMath_tilde *x, t_int dirty)
+{
+  if(x->joinStale[dirty]) return;
+  x->joinStale[dirty] = 1;
+  x->joinList[x->joinCount++] = dirty;
+  clock_delay(x->joinClock, 0);
+}
+
+// var 1-based, 0 = the sequence of the slot
+static void joinResolve(t_polyMath_tilde *x, t_int slot, t_int var)
+{
+  t_int isVar = var > 0;
+  t_int base = isVar ? slot * MAXSEQ + (var - 1) * x->SEQSIZE : slot * MAXSEQ;
+  t_int len = isVar ? x->var.len[slot + (var - 1) * SLOTS] : x->seq.len[slot];
+  t_atom *join = isVar ? x->var.eJoin : x->seq.eJoin;
+  t_atom *eSize = isVar ? x->var.eSize : x->seq.eSize;
+  t_atom *jSize = isVar ? x->var.jSize : x->seq.jSize;
+  t_int *jRun = isVar ? x->var.jRun : x->seq.jRun;
+  t_int k, i, run;
+  t_float size;
+  for(k = 0; k < len; k += run)
+    {
+      run = (t_int)atom_getfloat(&join[base + k]);
+      run = run < 1 ? 1 : run > len - k ? len - k : run;
+      size = 0;
+      for(i = k; i < k + run; i++) size += atom_getfloat(&eSize[base + i]);
+      jRun[base + k] = run;
+      SETFLOAT(&jSize[base + k], size);
+      for(i = k + 1; i < k + run; i++)
+	{
+	  jRun[base + i] = -1;
+	  SETFLOAT(&jSize[base + i], 0);
+	}
+    }
+}
+
+void polyMath_tilde_joinCache(t_polyMath_tilde *x)
+{
+  t_int i;
+  clock_unset(x->joinClock);
+  for(i = 0; i < x->joinCount; i++)
+    {
+      joinResolve(x, x->joinList[i] % SLOTS, x->joinList[i] / SLOTS);
+      x->joinStale[x->joinList[i]] = 0;
+    }
+  x->joinCount = 0;
+}
+
+static void markDirty(t_polyMath_tilde *x, t_int slot, t_int var, t_int field, t_int start, t_int end)
+{
+  t_int dirty;
+  if(slot < 0 || slot >= SLOTS || var < 0 || var > VARIATIONS) return;
+  dirty = slot + var * SLOTS;
+  if(start > end)
+    {
+      t_int swapEnd = start;
+      start = end;
+      end = swapEnd;
+    }
+  if(x->dirtyFields[dirty] == 0)
+    {
+      x->dirtyStart[dirty] = start;
+      x->dirtyEnd[dirty] = end;
+      x->dirtyList[x->dirtyCount++] = dirty;
+    }
+  else
+    {
+      if(start < x->dirtyStart[dirty]) x->dirtyStart[dirty] = start;
+      if(end > x->dirtyEnd[dirty]) x->dirtyEnd[dirty] = end;
+    }
+  x->dirtyFields[dirty] |= dirtyBit(field);
+  if(var >= VARIATIONS - 1) x->poolStaged[slot] &= ~(1 << (var - VARIATIONS + 1)); // edited: no longer a pool copy
+  if(field < 0 || field == 1 || field == 4) joinMark(x, dirty); // eSize or eJoin
+  // the morph mask compares eOff, eSize and eJoin of the sequence and the variation: rebuilt by morphClock
+  if(x->morphAmt > 0 && slot == x->morphSlot && (var == 0 || var == x->morphVar) && (field <= 1 || field == 4))
+    clock_delay(x->morphClock, 0);
+  if(x->notifyChanges && !x->txApplying) clock_delay(x->changeOut, 0);
+}
+
+/* TRANSACTIONS
+ * between begin and end, pSet, pSetOnly, vSetOnly, pSetRange, pSetLane, seqUnit, makeJoin, setJoins, swap,
+ * insertGroup, deleteGroup, nest and unnest are queued instead of being applied. end applies them all in one pass, then regroups each
+ * edited sequence once, and sends a single change notification.
+ */
+// called first by each queueable method: 1 = queued, return
+static t_int txQueue(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int need, i;
+  if(!x->txOpen || x->txApplying) return(0);
+  need = x->txLen + argc + 2;
+  if(need > x->txSize)
+    {
+      i = x->txSize ? x->txSize : 256;
+      while(i < need) i *= 2;
+      x->txBuf = x->txSize ? (t_atom *)resizebytes(x->txBuf, x->txSize * sizeof(t_atom), i * sizeof(t_atom)) : (t_atom *)getbytes(i * sizeof(t_atom));
+      x->txSize = x->txBuf ? i : 0;
+      if(x->txBuf == 0)
+	{
+	  post("begin: out of memory, edits are applied straight away");
+	  x->txOpen = x->txLen = 0;
+	  return(0);
+	}
+    }
+  SETSYMBOL(&x->txBuf[x->txLen], s);
+  SETFLOAT(&x->txBuf[x->txLen + 1], (t_float)argc);
+  for(i = 0; i < argc; i++) x->txBuf[x->txLen + 2 + i] = argv[i];
+  x->txLen = need;
+  x->txQueued++;
+  return(1);
+}
+
+// while applying: remember the range to regroup (var 1-based, 0 = the sequence) instead of regrouping now
+static void txRegroup(t_polyMath_tilde *x, t_int slot, t_int var, t_int from, t_int to)
+{
+  t_int t = slot + var * SLOTS;
+  if(x->txFrom[t] < 0)
+    {
+      x->txFrom[t] = from;
+      x->txTo[t] = to;
+      x->txList[x->txRegroups++] = t;
+    }
+  else
+    {
+      if(from < x->txFrom[t]) x->txFrom[t] = from;
+      if(to > x->txTo[t]) x->txTo[t] = to;
+    }
+}
+
+/* sequence array lookup by dType (see the list at the top of this file) - used by the paged
+ * and streamed getSequence and by lookahead so that a value can be read without the full switch in getSeq
+ */
+static t_atom *seqFieldArray(t_polyMath_tilde *x, t_int isVar, t_int field)
+{
+  switch(field)
+    {
+    case(0): return(isVar ? x->var.eOff : x->seq.eOff);
+    case(1): return(isVar ? x->var.eSize : x->seq.eSize);
+    case(2): return(isVar ? x->var.groupStep : x->seq.groupStep);
+    case(3): return(isVar ? x->var.groupNum : x->seq.groupNum);
+    case(4): return(isVar ? x->var.eJoin : x->seq.eJoin);
+    case(5): return(isVar ? x->var.jSize : x->seq.jSize);
+    case(11): return(isVar ? x->var.pAcc1 : x->seq.pAcc1);
+    case(12): return(isVar ? x->var.eAcc1 : x->seq.eAcc1);
+    case(13): return(isVar ? x->var.pAcc2 : x->seq.pAcc2);
+    case(14): return(isVar ? x->var.eAcc2 : x->seq.eAcc2);
+    case(15): return(isVar ? x->var.pAcc3 : x->seq.pAcc3);
+    case(16): return(isVar ? x->var.eAcc3 : x->seq.eAcc3);
+    case(17): return(isVar ? x->var.pAcc4 : x->seq.pAcc4);
+    case(18): return(isVar ? x->var.eAcc4 : x->seq.eAcc4);
+    case(19): return(isVar ? x->var.pAcc5 : x->seq.pAcc5);
+    case(20): return(isVar ? x->var.eAcc5 : x->seq.eAcc5);
+    case(21): return(isVar ? x->var.pAcc6 : x->seq.pAcc6);
+    case(22): return(isVar ? x->var.eAcc6 : x->seq.eAcc6);
+    case(23): return(isVar ? x->var.pAcc7 : x->seq.pAcc7);
+    case(24): return(isVar ? x->var.eAcc7 : x->seq.eAcc7);
+    case(25): return(isVar ? x->var.pAcc8 : x->seq.pAcc8);
+    case(26): return(isVar ? x->var.eAcc8 : x->seq.eAcc8);
+    default: return(0);
+    }
+}
+
+// field lookup for the background scramble and the variation pool - see the BUILDFIELDS list
+static t_atom *buildField(t_polyMath_tilde *x, t_int isVar, t_int f)
+{
+  switch(f)
+    {
+    case(0): return(isVar ? x->var.allStep : x->seq.allStep);
+    case(1): return(isVar ? x->var.varStep : x->seq.allStep);
+    case(2): return(isVar ? x->var.groupStep : x->seq.groupStep);
+    case(3): return(isVar ? x->var.groupNum : x->seq.groupNum);
+    case(4): return(isVar ? x->var.eSize : x->seq.eSize);
+    case(5): return(isVar ? x->var.eOff : x->seq.eOff);
+    case(6): return(isVar ? x->var.eJoin : x->seq.eJoin);
+    case(7): return(isVar ? x->var.jSize : x->seq.jSize);
+    case(8): return(isVar ? x->var.eSizeInv : x->seq.eSizeInv);
+    case(9): return(isVar ? x->var.denom : x->seq.denom);
+    case(10): return(isVar ? x->var.pAcc1 : x->seq.pAcc1);
+    case(11): return(isVar ? x->var.pAcc2 : x->seq.pAcc2);
+    case(12): return(isVar ? x->var.pAcc3 : x->seq.pAcc3);
+    case(13): return(isVar ? x->var.pAcc4 : x->seq.pAcc4);
+    case(14): return(isVar ? x->var.pAcc5 : x->seq.pAcc5);
+    case(15): return(isVar ? x->var.pAcc6 : x->seq.pAcc6);
+    case(16): return(isVar ? x->var.pAcc7 : x->seq.pAcc7);
+    case(17): return(isVar ? x->var.pAcc8 : x->seq.pAcc8);
+    case(18): return(isVar ? x->var.eAcc1 : x->seq.eAcc1);
+    case(19): return(isVar ? x->var.eAcc2 : x->seq.eAcc2);
+    case(20): return(isVar ? x->var.eAcc3 : x->seq.eAcc3);
+    case(21): return(isVar ? x->var.eAcc4 : x->seq.eAcc4);
+    case(22): return(isVar ? x->var.eAcc5 : x->seq.eAcc5);
+    case(23): return(isVar ? x->var.eAcc6 : x->seq.eAcc6);
+    case(24): return(isVar ? x->var.eAcc7 : x->seq.eAcc7);
+    case(25): return(isVar ? x->var.eAcc8 : x->seq.eAcc8);
+    case(26): return(isVar ? x->var.varOff : 0);
+    case(27): return(isVar ? x->var.grpOff : 0);
+    default: return(0);
+    }
+}
+
+/* MORPH
+ * morph slot var amount: while the sequence of slot plays, each event (join run) is taken from variation var
+ * with probability amount, decided as it starts. Only events whose run has the same length, sizes and offset in
+ * the variation as in the sequence can be swapped (morphMask), so timing and joins are those of the sequence.
+ * An edit of either one that reaches markDirty rebuilds the mask on morphClock.
+ */
+static void morphMaskOut(t_polyMath_tilde *x)
+{
+  t_int so = x->morphSlot * MAXSEQ;
+  t_int vo = so + (x->morphVar - 1) * x->SEQSIZE;
+  t_int len = x->seq.len[x->morphSlot];
+  t_int p, q, run, same;
+  if(x->var.len[x->morphSlot + (x->morphVar - 1) * SLOTS] < len) len = 0;
+  for(p = 0; p < len; p += run)
+    {
+      run = (t_int)atom_getfloatarg(so + p, x->SEQSIZE, x->seq.eJoin);
+      run = run > 1 ? run : 1;
+      run = p + run > len ? len - p : run;
+      same = atom_getfloatarg(vo + p, x->VARSIZE, x->var.eJoin) == atom_getfloatarg(so + p, x->SEQSIZE, x->seq.eJoin)
+	&& atom_getfloatarg(vo + p, x->VARSIZE, x->var.varOff) == atom_getfloatarg(so + p, x->SEQSIZE, x->seq.eOff);
+      for(q = p; q < p + run && same; q++)
+	same = atom_getfloatarg(vo + q, x->VARSIZE, x->var.eSize) == atom_getfloatarg(so + q, x->SEQSIZE, x->seq.eSize);
+      for(q = p; q < p + run; q++) x->morphMask[q] = same ? (q == p ? 1 : 2) : 0;
+    }
+  for(; p < MAXSEQ && p < x->seq.len[x->morphSlot]; p++) x->morphMask[p] = 0;
+}
+
+void polyMath_tilde_morphMask(t_polyMath_tilde *x)
+{
+  clock_unset(x->morphClock);
+  if(x->morphAmt > 0) morphMaskOut(x);
+}
+
+// called from getVariables: take the accents of this event from the variation
+static void morphEvent(t_polyMath_tilde *x)
+{
+  t_int loc;
+  if(x->PStep < 0 || x->PStep >= MAXSEQ) return;
+  if(x->morphMask[x->PStep] == 1) x->morphOn = playRandom(x) < x->morphAmt;
+  else if(x->morphMask[x->PStep] == 0) x->morphOn = 0;
+  if(!x->morphOn) return;
+  loc = x->slot * MAXSEQ + (x->morphVar - 1) * x->SEQSIZE + x->PStep;
+  x->clockOut = atom_getfloatarg(loc, x->VARSIZE, x->var.allStep);
+  x->E_Acc1 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc1);
+  x->E_Acc2 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc2);
+  x->E_Acc3 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc3);
+  x->E_Acc4 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc4);
+  x->E_Acc5 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc5);
+  x->E_Acc6 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc6);
+  x->E_Acc7 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc7);
+  x->E_Acc8 = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc8);
+  x->Pacc1 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc1);
+  x->Pacc2 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc2);
+  x->Pacc3 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc3);
+  x->Pacc4 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc4);
+  x->Pacc5 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc5);
+  x->Pacc6 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc6);
+  x->Pacc7 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc7);
+  x->Pacc8 = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc8);
+  SETFLOAT(&x->seq.pList1[0], x->Pacc1); SETFLOAT(&x->seq.pList1[1], x->E_Acc1);
+  SETFLOAT(&x->seq.pList2[0], x->Pacc2); SETFLOAT(&x->seq.pList2[1], x->E_Acc2);
+  SETFLOAT(&x->seq.pList3[0], x->Pacc3); SETFLOAT(&x->seq.pList3[1], x->E_Acc3);
+  SETFLOAT(&x->seq.pList4[0], x->Pacc4); SETFLOAT(&x->seq.pList4[1], x->E_Acc4);
+  SETFLOAT(&x->seq.pList5[0], x->Pacc5); SETFLOAT(&x->seq.pList5[1], x->E_Acc5);
+  SETFLOAT(&x->seq.pList6[0], x->Pacc6); SETFLOAT(&x->seq.pList6[1], x->E_Acc6);
+  SETFLOAT(&x->seq.pList7[0], x->Pacc7); SETFLOAT(&x->seq.pList7[1], x->E_Acc7);
+  SETFLOAT(&x->seq.pList8[0], x->Pacc8); SETFLOAT(&x->seq.pList8[1], x->E_Acc8);
+}
+
 static void getVariables(t_polyMath_tilde *x)
 {
-  x->clockOut = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.allStep);
-  x->E_Acc1 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc1);
-  x->E_Acc2 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc2);
-  x->E_Acc3 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc3);
-  x->E_Acc4 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc4);
-  x->Pacc1 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc1);
-  x->Pacc2 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc2);
-  x->Pacc3 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc3);
-  x->Pacc4 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc4);
-  x->E_Acc5 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc5);
-  x->E_Acc6 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc6);
-  x->E_Acc7 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc7);
-  x->E_Acc8 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eAcc8);
-  x->Pacc5 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc5);
-  x->Pacc6 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc6);
-  x->Pacc7 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc7);
-  x->Pacc8 = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.pAcc8);
+  // generative playback reads the chosen event of the base slot instead of the step in order
+  t_int loc = x->slot * MAXSEQ + (x->genSlot == x->slot ? x->genSrc : x->PStep);
+  x->clockOut = atom_getfloatarg(loc, x->SEQSIZE, x->seq.allStep);
+  x->E_Acc1 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc1);
+  x->E_Acc2 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc2);
+  x->E_Acc3 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc3);
+  x->E_Acc4 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc4);
+  x->Pacc1 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc1);
+  x->Pacc2 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc2);
+  x->Pacc3 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc3);
+  x->Pacc4 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc4);
+  x->E_Acc5 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc5);
+  x->E_Acc6 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc6);
+  x->E_Acc7 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc7);
+  x->E_Acc8 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc8);
+  x->Pacc5 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc5);
+  x->Pacc6 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc6);
+  x->Pacc7 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc7);
+  x->Pacc8 = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc8);
   SETFLOAT(&x->seq.pList1[0], x->Pacc1); SETFLOAT(&x->seq.pList1[1], x->E_Acc1);
   SETFLOAT(&x->seq.pList2[0], x->Pacc2); SETFLOAT(&x->seq.pList2[1], x->E_Acc2);
   SETFLOAT(&x->seq.pList3[0], x->Pacc3); SETFLOAT(&x->seq.pList3[1], x->E_Acc3);
@@ -378,29 +886,30 @@ static void getVariables(t_polyMath_tilde *x)
   SETFLOAT(&x->seq.pList6[0], x->Pacc6); SETFLOAT(&x->seq.pList6[1], x->E_Acc6);
   SETFLOAT(&x->seq.pList7[0], x->Pacc7); SETFLOAT(&x->seq.pList7[1], x->E_Acc7);
   SETFLOAT(&x->seq.pList8[0], x->Pacc8); SETFLOAT(&x->seq.pList8[1], x->E_Acc8);
-  if(x->myBug == 4) post("P2 = %f, E2 = %f, Location = %d",atom_getfloatarg(0,2,x->seq.pList2),atom_getfloatarg(1,2,x->seq.pList2),x->slot * MAXSEQ + x->PStep);
-  //x->Pthis = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eSize);
-  x->PJoin = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eJoin);
+  if(x->myBug == 4) post("P2 = %f, E2 = %f, Location = %d",atom_getfloatarg(0,2,x->seq.pList2),atom_getfloatarg(1,2,x->seq.pList2),loc);
+  //x->Pthis = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eSize);
+  x->PJoin = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eJoin);
+  x->PJRun = x->seq.jRun[loc];
+  x->PJSize = atom_getfloatarg(loc, x->SEQSIZE, x->seq.jSize);
   //  if(x->Pthis == 0 && x->PJoin > 1) x->Pthis = x->PJoin;
 
-  //assignment of PJoined happens here, and then the value is manipulated in perform. See "FLAGS"
-  //  if(x->PJoin > 1) x->PJoined = x->PJoin; // see below
-  x->Gnm = (t_int)atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.groupNum);
-  x->Gstep = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.groupStep);
+  x->Gnm = (t_int)atom_getfloatarg(loc, x->SEQSIZE, x->seq.groupNum);
+  x->Gstep = atom_getfloatarg(loc, x->SEQSIZE, x->seq.groupStep);
   // trying this in perform, since it now inhabits a signal outlet:
-  //x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
-  x->PESize = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eSize);
-  x->PESInv = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eSizeInv);
-  // 2017 30th October:
-  // FLAGS::::::In the clockGen_tilde_perform function
-  /* When a value of an element of x->seq.eJoin is encountered that is greater than 1, its value should be passed to x->PJoined.
-   * The JPESI value is set to 1 / the length of PESiz * x->PJoined.
-   * A flag, firstJoin is used to indicate that this was just set - if(x->firstJoin == 0) x->firstJoin = 1;. Another flag, jFlag, is set to 1.
-   * Next step, the firstJoin flag is revoked - if(x->firstJoin == 1) x->firstJoin = 0; 
-   * but if x->jFlag remains 1 and x->PJoined > 0, x->JPESI is not reset.
-   * if x->PJoined == 0 (i.e. the else statement after if(x->PJoined > 0) then x->JPESI is reset to x->PESiz
-   * NOT FINISHED!
-   */
+  //x->PEOff = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eOff);
+  x->PESize = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eSize);
+  x->PESInv = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eSizeInv);
+  if(x->genSlot == x->slot)
+    {
+      // the last run of a generated cycle is cut or padded to end on the cycle
+      if(x->genSrc == x->genFitStep)
+	{
+	  x->PESize = x->genFitSize;
+	  x->PESInv = x->PESize > 0 ? 1 / x->PESize : 0;
+	}
+      if(x->PJRun > 1) x->PJSize = x->genRunSize;
+    }
+  // FLAGS: PJRun / PJSize come from the resolved join cache, checkJoinsOut sets PJoined, jFirst and JPESI from them
   x->Gn = atom_getfloatarg(x->slot * GROUPS + x->Gnm, x->GROUPSIZE, x->grp.n);
   x->Gd = atom_getfloatarg(x->slot * GROUPS + x->Gnm, x->GROUPSIZE, x->grp.d);
   x->GSize = atom_getfloatarg(x->slot * GROUPS + x->Gnm, x->GROUPSIZE, x->grp.size);
@@ -410,6 +919,7 @@ static void getVariables(t_polyMath_tilde *x)
   //if(x->GSize > 0) x->GSInv = 1 / x->GSize;
   x->cycles = x->grp.cycles[x->slot];
   x->eChanged = 0;
+  if(x->morphAmt > 0 && x->slot == x->morphSlot && x->genSlot != x->slot) morphEvent(x);
 }
 
 static void getVariations(t_polyMath_tilde *x)
@@ -441,8 +951,8 @@ static void getVariations(t_polyMath_tilde *x)
   SETFLOAT(&x->seq.pList8[0], x->Pacc8); SETFLOAT(&x->seq.pList8[1], x->E_Acc8);
   if(x->myBug == 4) post("P2 = %f, E2 = %f, Location = %d",atom_getfloatarg(0,2,x->seq.pList2),atom_getfloatarg(1,2,x->seq.pList2),x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep);
   x->PJoin = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.eJoin);
-  //assignment of PJoined happens here, and then the value is manipulated in perform. See "FLAGS"
-  //  if(x->PJoin > 1) x->PJoined = x->PJoin; // see below
+  x->PJRun = x->var.jRun[x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep];
+  x->PJSize = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.jSize);
   x->Gnm = (t_int)atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.groupNum);
   //  if(x->Gnm != x->PrevG) x->PStepOff = 0;// see below
   x->Gstep = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.groupStep);
@@ -728,6 +1238,94 @@ void polyMath_tilde_altEarly(t_polyMath_tilde *x, t_floatarg f)
   x->altEarly = f > 0 ? 1 : 0;
 }
 
+/* LOOK-AHEAD
+ * Walks the next lookAhead events from the current step, following the jumps that are already scheduled
+ * (changeSlot/changeVar at nextShotVal, zeroNext* and jump*AtEnd at the end of the sequence).
+ * Times are in ms since the object was created, so they can be compared with each other across windows.
+ */
+#define LOOKAHEAD 64
+
+static void lookAheadOut(t_polyMath_tilde *x)
+{
+  t_int slot = x->slot;
+  t_int isVar = x->scrambling;
+  t_int var = x->varPerf;
+  t_int step = x->PStep;
+  t_int midJump = x->changeSlot || x->changeVar;
+  t_int k, i, len, seqOffset, arraySize, join;
+  t_float base = 0;
+  t_float now = x->InVal + x->PGcyc;
+  t_float start, size, durMs;
+  double then = clock_gettimesince(x->startTime);
+  t_atom *fieldArray;
+  join = isVar ? x->var.jRun[slot * MAXSEQ + var * x->SEQSIZE + step] : x->seq.jRun[slot * MAXSEQ + step];
+  step += join > 1 ? join : 1;
+  for(k = 1; k <= x->lookAhead; k++)
+    {
+      len = isVar ? x->var.len[slot + var * SLOTS] : x->seq.len[slot];
+      if(step >= len)
+	{
+	  base += isVar ? (t_float)x->vGrp.cycles[slot + var * SLOTS] : (t_float)x->grp.cycles[slot];
+	  step = 0;
+	  if(x->zeroNextSlot || x->jumpSlotAtEnd)
+	    {
+	      slot = x->nextSlot;
+	      isVar = 0;
+	    }
+	  else if(x->zeroNextVar || x->jumpVarAtEnd)
+	    {
+	      slot = x->nextSlot;
+	      isVar = 1;
+	      if(x->jumpVarAtEnd) var = x->nextVar - 1;
+	    }
+	  len = isVar ? x->var.len[slot + var * SLOTS] : x->seq.len[slot];
+	  if(len < 1) break;
+	}
+      seqOffset = isVar ? slot * MAXSEQ + var * x->SEQSIZE : slot * MAXSEQ;
+      arraySize = isVar ? x->VARSIZE : x->SEQSIZE;
+      start = base + atom_getfloatarg(seqOffset + step, arraySize, isVar ? x->var.varOff : x->seq.eOff);
+      if(midJump && start >= x->nextShotVal)
+	{
+	  // the scheduled jump lands here: continue from NStep of the next slot / variation
+	  midJump = 0;
+	  slot = x->nextSlot;
+	  isVar = x->changeVar;
+	  len = isVar ? x->var.len[slot + var * SLOTS] : x->seq.len[slot];
+	  if(len < 1) break;
+	  step = x->NStep % len;
+	  seqOffset = isVar ? slot * MAXSEQ + var * x->SEQSIZE : slot * MAXSEQ;
+	  arraySize = isVar ? x->VARSIZE : x->SEQSIZE;
+	  base = x->nextShotVal - atom_getfloatarg(seqOffset + step, arraySize, isVar ? x->var.varOff : x->seq.eOff);
+	  start = x->nextShotVal;
+	}
+      join = isVar ? x->var.jRun[seqOffset + step] : x->seq.jRun[seqOffset + step];
+      size = atom_getfloatarg(seqOffset + step, arraySize, join > 0 ? (isVar ? x->var.jSize : x->seq.jSize) : (isVar ? x->var.eSize : x->seq.eSize));
+      join = join > 1 ? join : 1;
+      durMs = x->barBeat * size;
+      SETFLOAT(&x->lookList[0], (t_float)k);
+      SETFLOAT(&x->lookList[1], (t_float)slot);
+      SETFLOAT(&x->lookList[2], isVar ? (t_float)(var + 1) : 0);
+      SETFLOAT(&x->lookList[3], (t_float)step);
+      SETFLOAT(&x->lookList[4], (t_float)(then + (start - now) * x->barBeat));
+      SETFLOAT(&x->lookList[5], durMs);
+      SETFLOAT(&x->lookList[6], durMs * sys_getsr() * 0.001);
+      for(i = 0; i < 16; i++)
+	{
+	  fieldArray = seqFieldArray(x, isVar, 11 + i);
+	  SETFLOAT(&x->lookList[7 + i], atom_getfloatarg(seqOffset + step, arraySize, fieldArray));
+	}
+      outlet_float(x->dType, 88);
+      outlet_list(x->dataOut, gensym("list"), 23, x->lookList);
+      step += join;
+    }
+}
+
+void polyMath_tilde_lookahead(t_polyMath_tilde *x, t_floatarg f)
+{
+  x->lookAhead = f < 0 ? 0 : f > LOOKAHEAD ? LOOKAHEAD : (t_int)f;
+  if(x->lookAhead > 0) lookAheadOut(x);
+}
+
 void polyMath_tilde_cout(t_polyMath_tilde *x)
 {
   SETFLOAT(&x->outList[0], (t_float)x->slot);
@@ -766,6 +1364,7 @@ void polyMath_tilde_cout(t_polyMath_tilde *x)
   outlet_float(x->cycle, (t_float)x->cycles);
   outlet_float(x->subclock, x->Gstep);
   outlet_float(x->clock, (t_float)x->PStep + x->PStepOff);
+  if(x->lookAhead > 0) lookAheadOut(x);
 }
 
 t_int writeGroup(t_polyMath_tilde *x, t_int group)
@@ -824,6 +1423,7 @@ t_int writeGroup(t_polyMath_tilde *x, t_int group)
 	      if(x->myBug == 1) post("Step = %d, GStep = %d, WESize = %f, Woff = %f, Write: %d",x->seq.len[x->slot] + x->d, x->d, x->WESize, x->Woff, x->slot * MAXSEQ + x->Wstep);
 	      if(x->myBug == 101) post("step: %d, gStep: %d, seq.eSize: %f, seq.eOff: %f",x->Wstep, (t_int)atom_getfloatarg(x->slot * MAXSEQ + x->Wstep, x->SEQSIZE, x->seq.groupStep), atom_getfloatarg(x->slot * MAXSEQ + x->Wstep, x->SEQSIZE, x->seq.eSize), atom_getfloatarg(x->slot * MAXSEQ + x->Wstep, x->SEQSIZE, x->seq.eOff));
 	    }
+	  markDirty(x, x->slot, 0, -1, x->seq.len[x->slot], x->seq.len[x->slot] + (t_int)x->Gn - 1);
 	  x->seq.len[x->slot] += (t_int)x->Gn;
 	  x->groupOffset += x->WESize * x->Gn;
 	  return(1);
@@ -831,40 +1431,6 @@ t_int writeGroup(t_polyMath_tilde *x, t_int group)
     }
 }
 
-t_int reWriteSeq(t_polyMath_tilde *x)
-{
-  for(x->j = x->Gstp + (t_int)x->JJoin; x->j < x->seq.len[x->JSlot]; x->j++)
-    {
-      x->k = x->j - (t_int)x->JJoin;
-      SETFLOAT(&x->seq.eSize[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eSize));
-      SETFLOAT(&x->seq.eJoin[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eJoin));
-      SETFLOAT(&x->seq.jSize[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.jSize));
-      SETFLOAT(&x->seq.eSizeInv[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eSizeInv));
-      SETFLOAT(&x->seq.eOff[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eOff));
-      SETFLOAT(&x->seq.allStep[x->JSlot * MAXSEQ + x->k], (t_float)x->k);
-      SETFLOAT(&x->seq.groupNum[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.groupNum));
-      // next line should have JGt offset
-      SETFLOAT(&x->seq.groupStep[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.groupStep) - x->JGt);
-      SETFLOAT(&x->seq.eAcc1[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc1));
-      SETFLOAT(&x->seq.eAcc2[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc2));
-      SETFLOAT(&x->seq.eAcc3[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc3));
-      SETFLOAT(&x->seq.eAcc4[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc4));
-      SETFLOAT(&x->seq.pAcc1[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc1));
-      SETFLOAT(&x->seq.pAcc2[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc2));
-      SETFLOAT(&x->seq.pAcc3[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc3));
-      SETFLOAT(&x->seq.pAcc4[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc4));
-      SETFLOAT(&x->seq.eAcc5[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc5));
-      SETFLOAT(&x->seq.eAcc6[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc6));
-      SETFLOAT(&x->seq.eAcc7[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc7));
-      SETFLOAT(&x->seq.eAcc8[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.eAcc8));
-      SETFLOAT(&x->seq.pAcc5[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc5));
-      SETFLOAT(&x->seq.pAcc6[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc6));
-      SETFLOAT(&x->seq.pAcc7[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc7));
-      SETFLOAT(&x->seq.pAcc8[x->JSlot * MAXSEQ + x->k], atom_getfloatarg(x->JSlot * MAXSEQ + x->j, x->SEQSIZE, x->seq.pAcc8));
-    }
-  return(1);
-}
-
 void polyMath_tilde_addGroup(t_polyMath_tilde *x, t_symbol *s, int argc, t_atom *argv)
 {
  if(argc == 3)
@@ -947,230 +1513,61 @@ void polyMath_tilde_sizeFrac(t_polyMath_tilde *x, t_floatarg f)
   x->sizeFrac = f > 0.001 ? f : 0.5;
 }
 
-// the next two functions should be moved to the start of the code, and initSeqSlot should be
-// called after the sequence is initialized thus: eventSeq_tilde_initSeqSlot(x, x->slot, 1);
-// The variation writing functions should have the values for seq.filled copied into var.filled
-t_int swapEventList(t_polyMath_tilde *x, t_int location, t_int slot, t_int var)
+// the EVENTLIST fields of an event, in eventList order
+static t_atom *eventField(t_polyMath_tilde *x, t_int isVar, t_int f)
 {
-  x->isSwapList = 0;
-  t_int varSeq = var - 1;
-  if(var > 0)
-    {
-      SETFLOAT(&x->eventList[0], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.allStep));
-      SETFLOAT(&x->eventList[1], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.filled));
-      SETFLOAT(&x->eventList[2], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.groupStep));
-      SETFLOAT(&x->eventList[3], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.groupNum));
-      SETFLOAT(&x->eventList[4], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eSize));
-      SETFLOAT(&x->eventList[5], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eOff));
-      SETFLOAT(&x->eventList[6], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eJoin));
-      SETFLOAT(&x->eventList[7], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.jSize));
-      SETFLOAT(&x->eventList[8], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc1));
-      SETFLOAT(&x->eventList[9], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc2));
-      SETFLOAT(&x->eventList[10], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc3));
-      SETFLOAT(&x->eventList[11], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc4));
-      SETFLOAT(&x->eventList[12], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc5));
-      SETFLOAT(&x->eventList[13], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc6));
-      SETFLOAT(&x->eventList[14], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc7));
-      SETFLOAT(&x->eventList[15], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eAcc8));
-      SETFLOAT(&x->eventList[16], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc1));
-      SETFLOAT(&x->eventList[17], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc2));
-      SETFLOAT(&x->eventList[18], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc3));
-      SETFLOAT(&x->eventList[19], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc4));
-      SETFLOAT(&x->eventList[20], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc5));
-      SETFLOAT(&x->eventList[21], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc6));
-      SETFLOAT(&x->eventList[22], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc7));
-      SETFLOAT(&x->eventList[23], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.pAcc8));
-      SETFLOAT(&x->eventList[24], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.eSizeInv));
-      SETFLOAT(&x->eventList[25], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.denom));
-      SETFLOAT(&x->eventList[26], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location, x->VARSIZE, x->var.altOff));
-      x->isSwapList = 1;
-    }
-  else
-    {
-      SETFLOAT(&x->eventList[0], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.allStep));
-      SETFLOAT(&x->eventList[1], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.filled));
-      SETFLOAT(&x->eventList[2], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.groupStep));
-      SETFLOAT(&x->eventList[3], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.groupNum));
-      SETFLOAT(&x->eventList[4], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eSize));
-      SETFLOAT(&x->eventList[5], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eOff));
-      SETFLOAT(&x->eventList[6], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eJoin));
-      SETFLOAT(&x->eventList[7], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.jSize));
-      SETFLOAT(&x->eventList[8], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc1));
-      SETFLOAT(&x->eventList[9], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc2));
-      SETFLOAT(&x->eventList[10], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc3));
-      SETFLOAT(&x->eventList[11], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc4));
-      SETFLOAT(&x->eventList[12], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc5));
-      SETFLOAT(&x->eventList[13], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc6));
-      SETFLOAT(&x->eventList[14], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc7));
-      SETFLOAT(&x->eventList[15], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eAcc8));
-      SETFLOAT(&x->eventList[16], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc1));
-      SETFLOAT(&x->eventList[17], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc2));
-      SETFLOAT(&x->eventList[18], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc3));
-      SETFLOAT(&x->eventList[19], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc4));
-      SETFLOAT(&x->eventList[20], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc5));
-      SETFLOAT(&x->eventList[21], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc6));
-      SETFLOAT(&x->eventList[22], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc7));
-      SETFLOAT(&x->eventList[23], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.pAcc8));
-      SETFLOAT(&x->eventList[24], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.eSizeInv));
-      SETFLOAT(&x->eventList[25], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.denom));
-      SETFLOAT(&x->eventList[26], atom_getfloatarg(slot * MAXSEQ + location, x->SEQSIZE, x->seq.altOff));
-      x->isSwapList = 1;
-    }
-  return(x->isSwapList);
-}
-
-t_int addEventList(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var)
-{
-  t_int isAdded = 0;
-  t_int varSeq = var - 1;
-  if(var > 0)
-    {
-      SETFLOAT(&x->var.allStep[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(0, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.filled[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(1, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.groupStep[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(2, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.groupNum[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(3, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eSize[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(4, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eOff[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(5, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eJoin[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(6, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.jSize[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(7, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc1[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(8, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc2[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(9, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc3[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(10, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc4[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(11, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc5[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(12, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc6[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(13, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc7[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(14, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eAcc8[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(15, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc1[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(16, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc2[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(17, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc3[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(18, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc4[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(19, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc5[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(20, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc6[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(21, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc7[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(22, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.pAcc8[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(23, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.eSizeInv[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(24, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.denom[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(25, EVENTLIST, x->eventList));
-      SETFLOAT(&x->var.altOff[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(26, EVENTLIST, x->eventList));
-      isAdded = 1;
-    }
-  else
-    {
-      SETFLOAT(&x->seq.allStep[slot * MAXSEQ + location], atom_getfloatarg(0, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.filled[slot * MAXSEQ + location], atom_getfloatarg(1, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.groupStep[slot * MAXSEQ + location], atom_getfloatarg(2, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.groupNum[slot * MAXSEQ + location], atom_getfloatarg(3, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eSize[slot * MAXSEQ + location], atom_getfloatarg(4, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eOff[slot * MAXSEQ + location], atom_getfloatarg(5, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eJoin[slot * MAXSEQ + location], atom_getfloatarg(6, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.jSize[slot * MAXSEQ + location], atom_getfloatarg(7, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc1[slot * MAXSEQ + location], atom_getfloatarg(8, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc2[slot * MAXSEQ + location], atom_getfloatarg(9, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc3[slot * MAXSEQ + location], atom_getfloatarg(10, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc4[slot * MAXSEQ + location], atom_getfloatarg(11, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc5[slot * MAXSEQ + location], atom_getfloatarg(12, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc6[slot * MAXSEQ + location], atom_getfloatarg(13, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc7[slot * MAXSEQ + location], atom_getfloatarg(14, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eAcc8[slot * MAXSEQ + location], atom_getfloatarg(15, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc1[slot * MAXSEQ + location], atom_getfloatarg(16, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc2[slot * MAXSEQ + location], atom_getfloatarg(17, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc3[slot * MAXSEQ + location], atom_getfloatarg(18, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc4[slot * MAXSEQ + location], atom_getfloatarg(19, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc5[slot * MAXSEQ + location], atom_getfloatarg(20, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc6[slot * MAXSEQ + location], atom_getfloatarg(21, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc7[slot * MAXSEQ + location], atom_getfloatarg(22, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.pAcc8[slot * MAXSEQ + location], atom_getfloatarg(23, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.eSizeInv[slot * MAXSEQ + location], atom_getfloatarg(24, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.denom[slot * MAXSEQ + location], atom_getfloatarg(25, EVENTLIST, x->eventList));
-      SETFLOAT(&x->seq.altOff[slot * MAXSEQ + location], atom_getfloatarg(26, EVENTLIST, x->eventList));
-      isAdded = 1;
-    }
-  return(isAdded);
-}
-
-t_int oneToTheRightOrLeft(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var, t_int dir)
-{ //tests are carried out in the parent function to make sure this is a valid swap
-  t_int swapShuffle = 0;
-  t_int location2 = location - 1;
-  if(dir == -1) location2 = location + 1;
-  t_int varSeq  = var - 1;
-  if(var > 0)
+  switch(f)
     {
-      if(location >= len)
-	{
-	  //case for moving to the end - or is that impossible?
-	}
-      else
-	{
-	  SETFLOAT(&x->var.allStep[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.allStep));
-	  SETFLOAT(&x->var.filled[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.filled));
-	  SETFLOAT(&x->var.groupStep[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.groupStep));
-	  SETFLOAT(&x->var.groupNum[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.groupNum));
-	  SETFLOAT(&x->var.eSize[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eSize));
-	  SETFLOAT(&x->var.eOff[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eOff));
-	  SETFLOAT(&x->var.eJoin[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eJoin));
-	  SETFLOAT(&x->var.jSize[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.jSize));
-	  SETFLOAT(&x->var.eAcc1[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc1));
-	  SETFLOAT(&x->var.eAcc2[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc2));
-	  SETFLOAT(&x->var.eAcc3[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc3));
-	  SETFLOAT(&x->var.eAcc4[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc4));
-	  SETFLOAT(&x->var.eAcc5[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc5));
-	  SETFLOAT(&x->var.eAcc6[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc6));
-	  SETFLOAT(&x->var.eAcc7[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc7));
-	  SETFLOAT(&x->var.eAcc8[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eAcc8));
-	  SETFLOAT(&x->var.pAcc1[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc1));
-	  SETFLOAT(&x->var.pAcc2[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc2));
-	  SETFLOAT(&x->var.pAcc3[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc3));
-	  SETFLOAT(&x->var.pAcc4[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc4));
-	  SETFLOAT(&x->var.pAcc5[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc5));
-	  SETFLOAT(&x->var.pAcc6[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc6));
-	  SETFLOAT(&x->var.pAcc7[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc7));
-	  SETFLOAT(&x->var.pAcc8[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.pAcc8));
-	  SETFLOAT(&x->var.eSizeInv[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.eSizeInv));
-	  SETFLOAT(&x->var.denom[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.denom));
-	  SETFLOAT(&x->var.altOff[slot * MAXSEQ + varSeq * x->SEQSIZE + location], atom_getfloatarg(slot * MAXSEQ + varSeq * x->SEQSIZE + location2, x->VARSIZE, x->var.altOff));
-	  swapShuffle++;
-	}
+    case(0): return(isVar ? x->var.allStep : x->seq.allStep);
+    case(1): return(isVar ? x->var.filled : x->seq.filled);
+    case(2): return(isVar ? x->var.groupStep : x->seq.groupStep);
+    case(3): return(isVar ? x->var.groupNum : x->seq.groupNum);
+    case(4): return(isVar ? x->var.eSize : x->seq.eSize);
+    case(5): return(isVar ? x->var.eOff : x->seq.eOff);
+    case(6): return(isVar ? x->var.eJoin : x->seq.eJoin);
+    case(7): return(isVar ? x->var.jSize : x->seq.jSize);
+    case(8): return(isVar ? x->var.eAcc1 : x->seq.eAcc1);
+    case(9): return(isVar ? x->var.eAcc2 : x->seq.eAcc2);
+    case(10): return(isVar ? x->var.eAcc3 : x->seq.eAcc3);
+    case(11): return(isVar ? x->var.eAcc4 : x->seq.eAcc4);
+    case(12): return(isVar ? x->var.eAcc5 : x->seq.eAcc5);
+    case(13): return(isVar ? x->var.eAcc6 : x->seq.eAcc6);
+    case(14): return(isVar ? x->var.eAcc7 : x->seq.eAcc7);
+    case(15): return(isVar ? x->var.eAcc8 : x->seq.eAcc8);
+    case(16): return(isVar ? x->var.pAcc1 : x->seq.pAcc1);
+    case(17): return(isVar ? x->var.pAcc2 : x->seq.pAcc2);
+    case(18): return(isVar ? x->var.pAcc3 : x->seq.pAcc3);
+    case(19): return(isVar ? x->var.pAcc4 : x->seq.pAcc4);
+    case(20): return(isVar ? x->var.pAcc5 : x->seq.pAcc5);
+    case(21): return(isVar ? x->var.pAcc6 : x->seq.pAcc6);
+    case(22): return(isVar ? x->var.pAcc7 : x->seq.pAcc7);
+    case(23): return(isVar ? x->var.pAcc8 : x->seq.pAcc8);
+    case(24): return(isVar ? x->var.eSizeInv : x->seq.eSizeInv);
+    case(25): return(isVar ? x->var.denom : x->seq.denom);
+    case(26): return(isVar ? x->var.altOff : x->seq.altOff);
+    default: return(0);
     }
-  else
+}
+
+/* move the event at from to to (var 1-based, 0 = the sequence), shifting the events in between by one:
+ * one memmove per field instead of copying every field of every event in between. In a variation
+ * varStep follows the event, so the moved event keeps its source step.
+ */
+static t_int rotateEvents(t_polyMath_tilde *x, t_int slot, t_int var, t_int from, t_int to)
+{
+  t_int base = var > 0 ? slot * MAXSEQ + (var - 1) * x->SEQSIZE : slot * MAXSEQ;
+  t_int f;
+  t_atom *a;
+  t_atom held;
+  for(f = 0; f < EVENTLIST + (var > 0); f++)
     {
-      if(location == 0)
-	{
-	  //case for moving to the end, or is that impossible? 
-	}
-      else
-	{
-	  SETFLOAT(&x->seq.allStep[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.allStep));
-	  SETFLOAT(&x->seq.filled[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.filled));
-	  SETFLOAT(&x->seq.groupStep[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.groupStep));
-	  SETFLOAT(&x->seq.groupNum[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.groupNum));
-	  SETFLOAT(&x->seq.eSize[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eSize));
-	  SETFLOAT(&x->seq.eOff[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eOff));
-	  SETFLOAT(&x->seq.eJoin[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eJoin));
-	  SETFLOAT(&x->seq.jSize[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.jSize));
-	  SETFLOAT(&x->seq.eAcc1[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc1));
-	  SETFLOAT(&x->seq.eAcc2[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc2));
-	  SETFLOAT(&x->seq.eAcc3[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc3));
-	  SETFLOAT(&x->seq.eAcc4[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc4));
-	  SETFLOAT(&x->seq.eAcc5[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc5));
-	  SETFLOAT(&x->seq.eAcc6[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc6));
-	  SETFLOAT(&x->seq.eAcc7[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc7));
-	  SETFLOAT(&x->seq.eAcc8[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eAcc8));
-	  SETFLOAT(&x->seq.pAcc1[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc1));
-	  SETFLOAT(&x->seq.pAcc2[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc2));
-	  SETFLOAT(&x->seq.pAcc3[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc3));
-	  SETFLOAT(&x->seq.pAcc4[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc4));
-	  SETFLOAT(&x->seq.pAcc5[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc5));
-	  SETFLOAT(&x->seq.pAcc6[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc6));
-	  SETFLOAT(&x->seq.pAcc7[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc7));
-	  SETFLOAT(&x->seq.pAcc8[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.pAcc8));
-	  SETFLOAT(&x->seq.eSizeInv[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.eSizeInv));
-	  SETFLOAT(&x->seq.denom[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.denom));
-	  SETFLOAT(&x->seq.altOff[slot * MAXSEQ + location], atom_getfloatarg(slot * MAXSEQ + location2, x->SEQSIZE, x->seq.altOff));
-	  swapShuffle++;
-	}
+      a = (f < EVENTLIST ? eventField(x, var > 0, f) : x->var.varStep) + base;
+      held = a[from];
+      if(to > from) memmove(a + from, a + from + 1, (to - from) * sizeof(t_atom));
+      else memmove(a + to + 1, a + to, (from - to) * sizeof(t_atom));
+      a[to] = held;
     }
-  return(swapShuffle);
+  return(1);
 }
 
 t_int onePToTheLeftOrRight(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var, t_int P, t_int direction)
@@ -1353,190 +1750,584 @@ t_int oneEToTheLeftOrRight(t_polyMath_tilde *x, t_int location, t_int len, t_int
   return(swapShuffle);
 }
 
-void polyMath_tilde_swapElement(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+t_int regroup(t_polyMath_tilde *x, t_int grpOffset, t_int varOffset, t_int slot, t_int var, t_int len)
 {
-  t_int process = 0;
-  t_int shuffled = 0;
-  if(argc == 2)
+  x->groupWell = 1;
+  x->VGnm = 0;
+  x->VGCount = 0;
+  x->VGSize = 0;
+  for(x->p = 0; x->p < len; x->p++)
     {
-      x->swapSlot = x->slot;
-      x->swapVar = x->varPerf;
-      x->swapLoc = (t_int)atom_getfloat(argv);
-      x->swapShift = (t_int)atom_getfloat(argv+1);
-      if(x->varTest > 0)
+      //here is where we rewrite GROUPS
+      //t_int VGnm, VGCount, VEJoin;
+      //t_float Vd, VESize, VGSize, VEOff, VGOff, VJSize, VJoin, VVStep, VVLast, VONext;
+      x->VESize = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.eSize);
+      //x->VJSize = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.jSize);
+      x->VVStep = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.varStep);
+      x->Vd = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.denom);
+      x->VEOff = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.eOff);      
+      x->vGrp.cycles[slot + var * SLOTS] = x->grp.cycles[slot];
+      if(x->p == 0)
 	{
-	  x->swapLength = x->var.len[x->swapSlot + x->swapVar * SLOTS];
-	  if(x->swapLength < x->swapLoc + x->swapShift)
+	  x->VGSize += x->VESize;
+	  x->VGOff = x->VEOff;
+	  SETFLOAT(&x->vGrp.offset[grpOffset],x->VGOff);
+	  SETFLOAT(&x->vGrp.size[grpOffset],x->VGSize);
+	  if(x->VGSize <= 0) x->scramWell = 0;
+	  else
 	    {
-	      post("You cannot shift an element beyond the end of the sequence! Length = %d, newLoc = %d",x->var.len[x->swapSlot + x->swapVar * SLOTS], x->swapLoc + x->swapShift);
+	      x->VGSizeInv = 1 / x->VGSize;
+	      SETFLOAT(&x->vGrp.sizeInv[grpOffset],x->VGSizeInv);
 	    }
-//allStep filled groupStep groupNum eSize eOff eJoin jSize eAcc1-8 pAcc1-8 eSizeInv denom altOff
-	  else
-	    if(x->swapLoc >= 0 && x->swapLoc < x->swapLength)
-	      {
-		x->isSwapList = swapEventList(x, x->swapLoc, x->swapSlot, x->varTest);
-		if(x->swapShift > 0)
-		  {
-		    for(x->x=x->swapLoc; x->x < x->swapLoc + x->swapShift; x->x++)
-		      {
-			//jiggle events
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, x->varTest, -1);
-		      }
-		    //t_int addEventList(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var)
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, x->varTest);
-		  }
-		else if(x->swapShift < 0)
-		  {
-		    for(x->x = x->swapLoc; x->x > x->swapLoc + x->swapShift; x->x--)
-		      {
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, x->varTest, 0);
-		      }
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, x->varTest);
-		  }
-		if(!process)
-		  {
-		    post("Element was not moved successfully!");
-		  }
-		//if(shuffled == fabs(x->swapShift)
-	      }
-	    else
-	      {
-		post("You cannot move an element that doesn't exist, i.e. is beyond the sequence! Length = %d, Location = %d",x->var.len[x->swapSlot + x->swapVar * SLOTS], x->swapLoc);
-	      }
+	  SETFLOAT(&x->vGrp.n[grpOffset],(t_float)x->VGCount + 1);
+	  SETFLOAT(&x->vGrp.d[grpOffset],x->Vd);
+	  x->vGrp.gStart[grpOffset] = (t_int)x->VVStep;
+	  x->vGrp.nGroups[slot + var * SLOTS] = 1; //x->VGnm + 1
+	  x->VONext = x->VEOff + x->VESize;
+	  SETFLOAT(&x->var.groupStep[varOffset],0);
+	  SETFLOAT(&x->var.groupNum[varOffset],0);
+	  x->VVLast = x->VVStep;
+	  x->VLastD = x->Vd;
 	}
       else
 	{
-	  x->swapLength = x->seq.len[x->swapSlot];
-	  if(x->swapLength < x->swapLoc + x->swapShift)
+	  if(x->VEOff != x->VONext)
 	    {
-	      post("You cannot shift an element beyond the end of the sequence! Length = %d, newLoc = %d",x->var.len[x->swapSlot + x->swapVar * SLOTS], x->swapLoc + x->swapShift);
+	      x->VGnm++;
+	      x->VGCount = 0;
+	      x->VGSize = x->VESize;
+	      if(x->VGSize == 0) x->scramWell = 0;
+	      else x->VGSizeInv = 1 / x->VGSize;
+	      x->VGOff = x->VEOff;
+	      SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
+	      SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
+	      x->vGrp.gStart[grpOffset + x->VGnm] = (t_int)x->VVStep;
+	      x->vGrp.nGroups[slot + var * SLOTS] = x->VGnm + 1;
 	    }
-//allStep filled groupStep groupNum eSize eOff eJoin jSize eAcc1-8 pAcc1-8 eSizeInv denom altOff
-	  else
-	    if(x->swapLoc >= 0 && x->swapLoc < x->swapLength)
-	      {
-		x->isSwapList = swapEventList(x, x->swapLoc, x->swapSlot, 0);
-		if(x->swapShift > 0)
-		  {
-		    for(x->x=x->swapLoc; x->x < x->swapLoc + x->swapShift; x->x++)
-		      {
-			//jiggle events
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, 0, -1);
-		      }
-		    //t_int addEventList(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var)
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, x->varTest);
-		  }
-		else if(x->swapShift < 0)
-		  {
-		    for(x->x = x->swapLoc; x->x > x->swapLoc + x->swapShift; x->x--)
-		      {
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, 0, 0);
-		      }
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, 0);
-		  }
-		if(!process)
-		  {
-		    post("Element was not moved successfully!");
-		  }
-		//if(shuffled == fabs(x->swapShift)
-	      }
-	  //then deal with argc == 4 and argc == 6
-	}
-    }
-  else if(argc == 4)
-    {
-      x->swapSlot = (t_int)atom_getfloat(argv);
-      x->swapVar = (t_int)atom_getfloat(argv+1);
+	  else if(x->VVStep != x->VVLast + 1)
+	    {
+	      x->VGnm++;
+	      x->VGCount = 0;
+	      x->VGSize = x->VESize;
+	      if(x->VGSize == 0) x->scramWell = 0;
+	      else x->VGSizeInv = 1 / x->VGSize;
+	      x->VGOff = x->VEOff;
+	      SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
+	      SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
+	      x->vGrp.gStart[grpOffset + x->VGnm] = (t_int)x->VVStep;
+	      x->vGrp.nGroups[slot + var * SLOTS] = x->VGnm + 1;
+	    }
+	  else if(x->VLastD != x->Vd)
+	    {
+	      x->VGnm++;
+	      x->VGCount = 0;
+	      x->VGSize = x->VESize;
+	      if(x->VGSize == 0) x->scramWell = 0;
+	      else x->VGSizeInv = 1 / x->VGSize;
+	      x->VGOff = x->VEOff;
+	      SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
+	      SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
+	      x->vGrp.gStart[grpOffset + x->VGnm] = (t_int)x->VVStep;
+	      x->vGrp.nGroups[slot + var * SLOTS] = x->VGnm + 1;
+	    }
+	  else 
+	    {
+	      x->VGCount++;
+	      x->VGSize += x->VESize;
+	      if(x->VGSize == 0) x->scramWell = 0;
+	      else x->VGSizeInv = 1 / x->VGSize;
+	    }
+	  SETFLOAT(&x->vGrp.offset[grpOffset + x->VGnm],x->VGOff);
+	  SETFLOAT(&x->vGrp.size[grpOffset + x->VGnm],x->VGSize);
+	  SETFLOAT(&x->vGrp.sizeInv[grpOffset + x->VGnm],x->VGSizeInv);
+	  SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
+	  SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
+	  x->VONext = x->VEOff + x->VESize;
+	  SETFLOAT(&x->var.groupStep[varOffset + x->p],(t_float)x->VGCount);
+	  SETFLOAT(&x->var.groupNum[varOffset + x->p],x->VGnm);
+	  x->VVLast = x->VVStep;
+	  x->VLastD = x->Vd;
+	}
+    }
+  return(x->groupWell);
+}
+
+t_int varOffsets(t_polyMath_tilde *x, t_int varOffset, t_int len)
+{
+  x->varWrite = 1;
+  x->varOff = 0;
+  x->swapVal = 0;
+  for(x->p = 0; x->p < len; x->p++)
+    {
+      SETFLOAT(&x->var.varOff[varOffset + x->p], x->varOff);
+      x->swapVal1 = (t_int)atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.groupStep);
+      if(x->swapVal1 == 0) x->swapVal = x->varOff;
+      SETFLOAT(&x->var.grpOff[varOffset + x->p], x->swapVal);
+      x->varOff += atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.eSize);
+      if(x->myBug == 8) post("varOff = %f, grpOff = %f");
+    }
+  return(x->varWrite);
+}
+
+/* Incremental regroup + varOffsets after events from - to of a variation (var 1-based) were edited, or
+ * incremental event offsets for the sequence (var 0). It starts at the first edited event and stops at the
+ * first event after the edit that starts the same group at the same offset as before - nothing after it
+ * can have changed. Returns the end (exclusive) of what was rewritten.
+ */
+static t_int regroupFrom(t_polyMath_tilde *x, t_int slot, t_int var, t_int from, t_int to)
+{
+  t_int v = var - 1;
+  t_int vo = slot * MAXSEQ + v * x->SEQSIZE;
+  t_int go = slot * GROUPS + v * x->GROUPSIZE;
+  t_int len, p, gNum, gCount, newGroup;
+  t_float eSize, eOff, vStep, den, gSize, gOff, oNext, vLast, lastD, off, grpOff;
+  from = from < 0 ? 0 : from;
+  if(var == 0)
+    {
+      len = x->seq.len[slot];
+      vo = slot * MAXSEQ;
+      off = from > 0 ? atom_getfloatarg(vo + from - 1, x->SEQSIZE, x->seq.eOff) + atom_getfloatarg(vo + from - 1, x->SEQSIZE, x->seq.eSize) : 0;
+      for(p = from; p < len; p++)
+	{
+	  if(p > to && atom_getfloatarg(vo + p, x->SEQSIZE, x->seq.eOff) == off) break;
+	  SETFLOAT(&x->seq.eOff[vo + p], off);
+	  off += atom_getfloatarg(vo + p, x->SEQSIZE, x->seq.eSize);
+	}
+      return(p);
+    }
+  len = x->var.len[slot + v * SLOTS];
+  if(from == 0)
+    {
+      regroup(x, go, vo, slot, v, len);
+      varOffsets(x, vo, len);
+      return(len);
+    }
+  // carry the state of the event before the edit
+  p = from - 1;
+  gNum = (t_int)atom_getfloatarg(vo + p, x->VARSIZE, x->var.groupNum);
+  gCount = (t_int)atom_getfloatarg(vo + p, x->VARSIZE, x->var.groupStep);
+  eSize = atom_getfloatarg(vo + p, x->VARSIZE, x->var.eSize);
+  oNext = atom_getfloatarg(vo + p, x->VARSIZE, x->var.eOff) + eSize;
+  vLast = atom_getfloatarg(vo + p, x->VARSIZE, x->var.varStep);
+  lastD = atom_getfloatarg(vo + p, x->VARSIZE, x->var.denom);
+  off = atom_getfloatarg(vo + p, x->VARSIZE, x->var.varOff) + eSize;
+  grpOff = atom_getfloatarg(vo + p, x->VARSIZE, x->var.grpOff);
+  gSize = off - grpOff;
+  gOff = atom_getfloatarg(go + gNum, x->VGROUPSIZE, x->vGrp.offset);
+  // the carried group may now end at from - 1
+  SETFLOAT(&x->vGrp.size[go + gNum], gSize);
+  if(gSize > 0) SETFLOAT(&x->vGrp.sizeInv[go + gNum], 1 / gSize);
+  SETFLOAT(&x->vGrp.n[go + gNum], (t_float)gCount + 1);
+  for(p = from; p < len; p++)
+    {
+      eSize = atom_getfloatarg(vo + p, x->VARSIZE, x->var.eSize);
+      eOff = atom_getfloatarg(vo + p, x->VARSIZE, x->var.eOff);
+      vStep = atom_getfloatarg(vo + p, x->VARSIZE, x->var.varStep);
+      den = atom_getfloatarg(vo + p, x->VARSIZE, x->var.denom);
+      newGroup = eOff != oNext || vStep != vLast + 1 || den != lastD;
+      // stop once the old layout starts the same group here: same number, first step, same offset
+      if(p > to && newGroup && atom_getfloatarg(vo + p, x->VARSIZE, x->var.groupNum) == gNum + 1
+	 && atom_getfloatarg(vo + p, x->VARSIZE, x->var.groupStep) == 0
+	 && atom_getfloatarg(vo + p, x->VARSIZE, x->var.varOff) == off) break;
+      if(newGroup)
+	{
+	  gNum++;
+	  gCount = 0;
+	  gSize = eSize;
+	  gOff = eOff;
+	  grpOff = off;
+	  x->vGrp.gStart[go + gNum] = (t_int)vStep;
+	}
+      else
+	{
+	  gCount++;
+	  gSize += eSize;
+	}
+      SETFLOAT(&x->vGrp.offset[go + gNum], gOff);
+      SETFLOAT(&x->vGrp.size[go + gNum], gSize);
+      if(gSize > 0) SETFLOAT(&x->vGrp.sizeInv[go + gNum], 1 / gSize);
+      SETFLOAT(&x->vGrp.n[go + gNum], (t_float)gCount + 1);
+      SETFLOAT(&x->vGrp.d[go + gNum], den);
+      SETFLOAT(&x->var.groupStep[vo + p], (t_float)gCount);
+      SETFLOAT(&x->var.groupNum[vo + p], (t_float)gNum);
+      SETFLOAT(&x->var.varOff[vo + p], off);
+      SETFLOAT(&x->var.grpOff[vo + p], grpOff);
+      oNext = eOff + eSize;
+      vLast = vStep;
+      lastD = den;
+      off += eSize;
+    }
+  if(p == len) x->vGrp.nGroups[slot + v * SLOTS] = gNum + 1;
+  return(p);
+}
+
+/* UNDO / REDO
+ * Before pSet, pSetOnly, vSetOnly, swap and makeJoin, and before a scramble result replaces a variation,
+ * the values about to change are saved as a record. undo writes a step's records back - the derived fields
+ * (event offsets, groups) are regrouped from the restored events - and keeps the values it replaced in the
+ * same record for redo. A new edit drops what could be redone. The oldest steps are dropped to keep the
+ * records within undoMemory. Edits that move events between groups (groupInSlot, setGroups, insertGroup,
+ * deleteGroup, nest) drop the records of that slot, because its saved ranges would no longer line up.
+ */
+static t_atom *undoField(t_polyMath_tilde *x, t_int isVar, t_int f)
+{
+  if(f < EVENTLIST) return(eventField(x, isVar, f));
+  else return(isVar ? x->var.varStep : 0);
+}
+
+static t_int undoFields(t_int mask, t_int isVar)
+{
+  t_int f, n = 0;
+  for(f = 0; f < UNDOFIELDS; f++) if((mask >> f) & 1 && (f < EVENTLIST || isVar)) n++;
+  return(n);
+}
+
+// copy count events from start of the fields in mask into (store = 1) or out of (store = 0) data
+static void undoCopy(t_polyMath_tilde *x, t_undoRec *r, t_atom *data, t_int count, t_int store)
+{
+  t_int base = r->var > 0 ? r->slot * MAXSEQ + (r->var - 1) * x->SEQSIZE : r->slot * MAXSEQ;
+  t_int f, k = 0;
+  t_atom *a;
+  if(count <= 0) return;
+  for(f = 0; f < UNDOFIELDS; f++)
+    {
+      if(!((r->mask >> f) & 1) || (f >= EVENTLIST && r->var == 0)) continue;
+      a = undoField(x, r->var > 0, f) + base + r->start;
+      if(store) memcpy(data + k * count, a, count * sizeof(t_atom));
+      else memcpy(a, data + k * count, count * sizeof(t_atom));
+      k++;
+    }
+}
+
+static void undoFree(t_polyMath_tilde *x, t_undoRec *r)
+{
+  if(r->data) freebytes(r->data, r->count * undoFields(r->mask, r->var > 0) * sizeof(t_atom));
+  x->undoBytes -= r->count * undoFields(r->mask, r->var > 0) * sizeof(t_atom);
+  r->data = 0;
+}
+
+static void undoClear(t_polyMath_tilde *x)
+{
+  t_int i;
+  for(i = 0; i < x->undoCount; i++) undoFree(x, &x->undo[(x->undoHead + i) % UNDORECORDS]);
+  x->undoHead = x->undoCount = x->undoCur = 0;
+}
+
+// drop the records of one slot and close the gaps, keeping the order of the others
+static void undoClearSlot(t_polyMath_tilde *x, t_int slot)
+{
+  t_int i, k = 0, cur = x->undoCur;
+  t_undoRec *r;
+  for(i = 0; i < x->undoCount; i++)
+    {
+      r = &x->undo[(x->undoHead + i) % UNDORECORDS];
+      if(r->slot == slot)
+	{
+	  undoFree(x, r);
+	  if(i < x->undoCur) cur--;
+	}
+      else
+	{
+	  if(k != i) x->undo[(x->undoHead + k) % UNDORECORDS] = *r;
+	  k++;
+	}
+    }
+  x->undoCount = k;
+  x->undoCur = cur;
+}
+
+// the step number for a new edit: everything applied by end, or built for one scrambleAll, is one step
+static t_int undoNext(t_polyMath_tilde *x)
+{
+  if(x->txApplying) return(x->undoStep);
+  return(++x->undoStep);
+}
+
+static void undoSave(t_polyMath_tilde *x, t_int step, t_int slot, t_int var, t_int start, t_int count, t_int whole, t_int mask)
+{
+  t_undoRec *r;
+  t_int i, oldest, len;
+  long bytes;
+  if(x->undoMax <= 0 || slot < 0 || slot >= SLOTS) return;
+  len = var > 0 ? x->var.len[slot + (var - 1) * SLOTS] : x->seq.len[slot];
+  if(whole) count = len - start;
+  if(start < 0 || count < 0 || start + count > MAXSEQ) return;
+  for(i = x->undoCur; i < x->undoCount; i++) undoFree(x, &x->undo[(x->undoHead + i) % UNDORECORDS]);
+  x->undoCount = x->undoCur;
+  bytes = count * undoFields(mask, var > 0) * sizeof(t_atom);
+  // drop the oldest steps, but never part of this one
+  while(x->undoCount && (x->undoBytes + bytes > x->undoMax || x->undoCount == UNDORECORDS))
+    {
+      oldest = x->undo[x->undoHead].step;
+      if(oldest == step) break;
+      while(x->undoCount && x->undo[x->undoHead].step == oldest)
+	{
+	  undoFree(x, &x->undo[x->undoHead]);
+	  x->undoHead = (x->undoHead + 1) % UNDORECORDS;
+	  x->undoCount--;
+	}
+      x->undoCur = x->undoCount;
+    }
+  if(x->undoBytes + bytes > x->undoMax || x->undoCount == UNDORECORDS)
+    {
+      post("undo: the edit does not fit in undoMemory - history cleared");
+      undoClear(x);
+      return;
+    }
+  r = &x->undo[(x->undoHead + x->undoCount) % UNDORECORDS];
+  r->step = step;
+  r->slot = slot;
+  r->var = var;
+  r->start = start;
+  r->count = count;
+  r->whole = whole;
+  r->len = len;
+  r->variations = var > 0 ? x->var.variations[slot + (var - 1) * SLOTS] : 1;
+  r->mask = mask;
+  r->data = bytes ? (t_atom *)getbytes(bytes) : 0;
+  if(bytes && r->data == 0)
+    {
+      post("undo: out of memory - history cleared");
+      undoClear(x);
+      return;
+    }
+  undoCopy(x, r, r->data, count, 1);
+  x->undoBytes += bytes;
+  x->undoCount++;
+  x->undoCur = x->undoCount;
+}
+
+// write a record back, keeping what it replaces in the record
+static void undoSwap(t_polyMath_tilde *x, t_undoRec *r)
+{
+  t_int ls = r->slot + (r->var - 1) * SLOTS;
+  t_int len = r->var > 0 ? x->var.len[ls] : x->seq.len[r->slot];
+  t_int count = r->whole ? (len > r->start ? len - r->start : 0) : r->count;
+  t_int nf = undoFields(r->mask, r->var > 0);
+  t_int end;
+  t_atom *now = count > 0 && nf > 0 ? (t_atom *)getbytes(count * nf * sizeof(t_atom)) : 0;
+  if(count > 0 && nf > 0 && now == 0)
+    {
+      post("undo: out of memory");
+      return;
+    }
+  undoCopy(x, r, now, count, 1);
+  undoCopy(x, r, r->data, r->count, 0);
+  end = r->start + (count > r->count ? count : r->count) - 1;
+  if(r->whole)
+    {
+      if(r->var > 0)
+	{
+	  x->var.len[ls] = r->len;
+	  r->variations ^= x->var.variations[ls];
+	  x->var.variations[ls] ^= r->variations;
+	  r->variations ^= x->var.variations[ls];
+	}
+      else x->seq.len[r->slot] = r->len;
+      r->len = len;
+    }
+  freebytes(r->data, r->count * nf * sizeof(t_atom));
+  x->undoBytes += (long)(count - r->count) * nf * sizeof(t_atom);
+  r->data = now;
+  r->count = count;
+  if(r->var == 0 || x->var.len[ls] > 0) regroupFrom(x, r->slot, r->var, r->start, end);
+  if(end >= r->start) markDirty(x, r->slot, r->var, -1, r->start, end);
+}
+
+void polyMath_tilde_undo(t_polyMath_tilde *x)
+{
+  t_int step;
+  if(x->undoCur == 0)
+    {
+      post("undo: nothing to undo");
+      return;
+    }
+  step = x->undo[(x->undoHead + x->undoCur - 1) % UNDORECORDS].step;
+  while(x->undoCur > 0 && x->undo[(x->undoHead + x->undoCur - 1) % UNDORECORDS].step == step)
+    {
+      undoSwap(x, &x->undo[(x->undoHead + x->undoCur - 1) % UNDORECORDS]);
+      x->undoCur--;
+    }
+}
+
+void polyMath_tilde_redo(t_polyMath_tilde *x)
+{
+  t_int step;
+  if(x->undoCur == x->undoCount)
+    {
+      post("redo: nothing to redo");
+      return;
+    }
+  step = x->undo[(x->undoHead + x->undoCur) % UNDORECORDS].step;
+  while(x->undoCur < x->undoCount && x->undo[(x->undoHead + x->undoCur) % UNDORECORDS].step == step)
+    {
+      undoSwap(x, &x->undo[(x->undoHead + x->undoCur) % UNDORECORDS]);
+      x->undoCur++;
+    }
+}
+
+// undoMemory kB: the most the undo records may use (default 4096), 0 = no undo
+void polyMath_tilde_undoMemory(t_polyMath_tilde *x, t_floatarg f)
+{
+  x->undoMax = f > 0 ? (long)f * 1024 : 0;
+  undoClear(x);
+}
+
+// the accent lanes of one step, for pSet (which = 3), pSetOnly (1) and vSetOnly (2)
+static void undoLane(t_polyMath_tilde *x, t_atom *argv, t_int which)
+{
+  t_int slot = (t_int)atom_getfloat(argv);
+  t_int step = (t_int)atom_getfloat(argv + 1);
+  t_int lane = (t_int)atom_getfloat(argv + 2);
+  t_int mask = 0;
+  if(lane < 1 || lane > 8) return;
+  step = step >= MAXSEQ ? MAXSEQ - 1 : step < 0 ? 0 : step;
+  if(which & 1) mask |= 1 << (15 + lane); // pAcc
+  if(which & 2) mask |= 1 << (7 + lane);  // eAcc
+  undoSave(x, undoNext(x), slot, 0, step, 1, 0, mask);
+}
+
+/* INSERT / DELETE GROUP
+ * The events after the edit are moved up or down with one memmove per field and the group arrays with one
+ * memmove each, so the edit itself only writes the events of the new group. Event offsets, allStep, groupNum
+ * and the group starts and offsets after the edit are left stale and fixed up once, from the lowest edited
+ * position, by the grpFix clock - any number of edits in the same logical time cost one pass. Anything that
+ * reads the groups or offsets of a slot before then calls groupFixSlot first.
+ */
+static t_int grpEvents(t_polyMath_tilde *x, t_int slot, t_int g)
+{
+  t_int end = g + 1 < x->grp.nGroups[slot] ? x->grp.gStart[slot * GROUPS + g + 1] : x->seq.len[slot];
+  return(end - x->grp.gStart[slot * GROUPS + g]);
+}
+
+static void groupMarkStale(t_polyMath_tilde *x, t_int slot, t_int g, t_int e)
+{
+  if(x->grpFixGroup[slot] < 0)
+    {
+      x->grpFixGroup[slot] = g;
+      x->grpFixEvent[slot] = e;
+      x->grpFixCount++;
+      clock_delay(x->grpFix, 0);
+    }
+  else
+    {
+      if(g < x->grpFixGroup[slot]) x->grpFixGroup[slot] = g;
+      if(e < x->grpFixEvent[slot]) x->grpFixEvent[slot] = e;
+    }
+}
+
+// the slot is written from scratch: a pending fix-up is dropped
+static void groupFixCancel(t_polyMath_tilde *x, t_int slot)
+{
+  if(x->grpFixGroup[slot] < 0) return;
+  x->grpFixGroup[slot] = x->grpFixEvent[slot] = -1;
+  x->grpFixCount--;
+}
+
+/* 1 if the last group is the fill group of groupInSlot: it pads the last cycle, and its one event sits
+ * just past seq.len so it is never played
+ */
+static t_int fillerGroup(t_polyMath_tilde *x, t_int slot)
+{
+  t_int go = slot * GROUPS;
+  t_int g, count = 0;
+  for(g = 0; g < x->grp.nGroups[slot]; g++) count += (t_int)atom_getfloatarg(go + g, x->GROUPSIZE, x->grp.n);
+  return(x->grp.nGroups[slot] > 1 && count > x->seq.len[slot]);
+}
+
+static void groupFixSlot(t_polyMath_tilde *x, t_int slot)
+{
+  t_int so = slot * MAXSEQ;
+  t_int go = slot * GROUPS;
+  t_int g = x->grpFixGroup[slot];
+  t_int e = x->grpFixEvent[slot];
+  t_int first = e;
+  t_int len = x->seq.len[slot];
+  t_int k, n;
+  t_float off, gap;
+  if(g < 0) return;
+  if(fillerGroup(x, slot)) x->grp.nGroups[slot]--;
+  off = e > 0 ? atom_getfloatarg(so + e - 1, x->SEQSIZE, x->seq.eOff) + atom_getfloatarg(so + e - 1, x->SEQSIZE, x->seq.eSize) : 0;
+  for(; g < x->grp.nGroups[slot]; g++)
+    {
+      n = (t_int)atom_getfloatarg(go + g, x->GROUPSIZE, x->grp.n);
+      x->grp.gStart[go + g] = e;
+      SETFLOAT(&x->grp.offset[go + g], off);
+      for(k = 0; k < n && e < len; k++, e++)
+	{
+	  SETFLOAT(&x->seq.allStep[so + e], (t_float)e);
+	  SETFLOAT(&x->seq.groupNum[so + e], (t_float)g);
+	  SETFLOAT(&x->seq.eOff[so + e], off);
+	  off += atom_getfloatarg(so + e, x->SEQSIZE, x->seq.eSize);
+	}
+    }
+  // the fill group is made again for the new length: a remainder shorter than sizeThreshold is absorbed
+  x->grp.cycles[slot] = (t_int)off;
+  gap = (t_float)x->grp.cycles[slot] + 1 - off;
+  if(gap < 1 && gap > x->sizeThreshold && 1 - gap > x->sizeThreshold && x->grp.nGroups[slot] < GROUPS && len < MAXSEQ)
+    {
+      g = x->grp.nGroups[slot]++;
+      SETFLOAT(&x->grp.n[go + g], 1);
+      SETFLOAT(&x->grp.d[go + g], 1 / gap);
+      SETFLOAT(&x->grp.size[go + g], gap);
+      SETFLOAT(&x->grp.sizeInv[go + g], 1 / gap);
+      SETFLOAT(&x->grp.offset[go + g], off);
+      x->grp.gStart[go + g] = len;
+      SETFLOAT(&x->seq.eSize[so + len], gap);
+      SETFLOAT(&x->seq.eOff[so + len], off);
+      SETFLOAT(&x->seq.eSizeInv[so + len], 1 / gap);
+      SETFLOAT(&x->seq.denom[so + len], 1 / gap);
+      SETFLOAT(&x->seq.allStep[so + len], (t_float)len);
+      SETFLOAT(&x->seq.groupStep[so + len], 0);
+      SETFLOAT(&x->seq.groupNum[so + len], (t_float)g);
+      SETFLOAT(&x->seq.eJoin[so + len], 1);
+      SETFLOAT(&x->seq.jSize[so + len], gap);
+      x->grp.cycles[slot]++;
+    }
+  else if(gap < 1 && gap <= x->sizeThreshold) x->grp.cycles[slot]++;
+  if(x->grp.cycles[slot] < 1) x->grp.cycles[slot] = 1;
+  x->grpFixGroup[slot] = x->grpFixEvent[slot] = -1;
+  x->grpFixCount--;
+  markDirty(x, slot, 0, -1, first, len - 1);
+}
+
+void polyMath_tilde_groupFix(t_polyMath_tilde *x)
+{
+  t_int slot;
+  clock_unset(x->grpFix);
+  for(slot = 0; slot < SLOTS && x->grpFixCount > 0; slot++) groupFixSlot(x, slot);
+}
+
+void polyMath_tilde_swapElement(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  t_int process = 0;
+  t_int var = 0; // 1-based, 0 = the sequence of the slot
+  if(argc == 2)
+    {
+      var = x->varTest;
+      x->swapSlot = x->slot;
+      x->swapVar = x->varPerf;
+      x->swapLoc = (t_int)atom_getfloat(argv);
+      x->swapShift = (t_int)atom_getfloat(argv+1);
+    }
+  else if(argc == 4)
+    {
+      x->swapSlot = (t_int)atom_getfloat(argv);
+      x->swapVar = (t_int)atom_getfloat(argv+1);
       x->swapLoc = (t_int)atom_getfloat(argv+2);
       x->swapShift = (t_int)atom_getfloat(argv+3);
-      if(x->swapSlot < 0 || x->swapSlot > SLOTS)
+      if(x->swapSlot < 0 || x->swapSlot >= SLOTS)
 	{
 	  post("slot is out of range: %d",x->swapSlot);
+	  return;
 	}
       else if(x->swapVar < 0 || x->swapVar > VARIATIONS)
 	{
 	  post("variation is out of range: %d",x->swapVar);
+	  return;
 	}
-      else if(x->swapVar > 0)
-	{
-	  x->swapVar--;
-	  x->swapLength = x->var.len[x->swapSlot + x->swapVar * SLOTS];
-	  if(x->swapLength < x->swapLoc + x->swapShift)
-	    {
-	      post("You cannot shift an element beyond the end of the sequence! Length = %d, newLoc = %d",x->var.len[x->swapSlot + x->swapVar * SLOTS], x->swapLoc + x->swapShift);
-	    }
-//allStep filled groupStep groupNum eSize eOff eJoin jSize eAcc1-8 pAcc1-8 eSizeInv denom altOff
-	  else
-	    if(x->swapLoc >= 0 && x->swapLoc < x->swapLength)
-	      {
-		x->isSwapList = swapEventList(x, x->swapLoc, x->swapSlot, x->varTest);
-		if(x->swapShift > 0)
-		  {
-		    for(x->x=x->swapLoc; x->x < x->swapLoc + x->swapShift; x->x++)
-		      {
-			//jiggle events
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, x->varTest, -1);
-		      }
-		    //t_int addEventList(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var)
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, x->varTest);
-		  }
-		else if(x->swapShift < 0)
-		  {
-		    for(x->x = x->swapLoc; x->x > x->swapLoc + x->swapShift; x->x--)
-		      {
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, x->varTest, 0);
-		      }
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, x->varTest);
-		  }
-		if(!process)
-		  {
-		    post("Element was not moved successfully!");
-		  }
-		//if(shuffled == fabs(x->swapShift)
-	      }
-	    else
-	      {
-		post("You cannot move an element that doesn't exist, i.e. is beyond the sequence! Length = %d, Location = %d",x->var.len[x->swapSlot + x->swapVar * SLOTS], x->swapLoc);
-	      }
-	}
-      else
-	{
-	  x->swapLength = x->seq.len[x->swapSlot];
-	  if(x->swapLength < x->swapLoc + x->swapShift)
-	    {
-	      post("You cannot shift an element beyond the end of the sequence! Length = %d, newLoc = %d",x->var.len[x->swapSlot + x->swapVar * SLOTS], x->swapLoc + x->swapShift);
-	    }
-//allStep filled groupStep groupNum eSize eOff eJoin jSize eAcc1-8 pAcc1-8 eSizeInv denom altOff
-	  else
-	    if(x->swapLoc >= 0 && x->swapLoc < x->swapLength)
-	      {
-		x->isSwapList = swapEventList(x, x->swapLoc, x->swapSlot, 0);
-		if(x->swapShift > 0)
-		  {
-		    for(x->x=x->swapLoc; x->x < x->swapLoc + x->swapShift; x->x++)
-		      {
-			//jiggle events
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, 0, -1);
-		      }
-		    //t_int addEventList(t_polyMath_tilde *x, t_int location, t_int len, t_int slot, t_int var)
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, x->varTest);
-		  }
-		else if(x->swapShift < 0)
-		  {
-		    for(x->x = x->swapLoc; x->x > x->swapLoc + x->swapShift; x->x--)
-		      {
-			shuffled += oneToTheRightOrLeft(x, x->x, x->swapLength, x->swapSlot, 0, 0);
-		      }
-		    process = addEventList(x, x->swapLoc + x->swapShift, x->swapLength, x->swapSlot, 0);
-		  }
-		if(!process)
-		  {
-		    post("Element was not moved successfully!");
-		  }
-		//if(shuffled == fabs(x->swapShift)
-	      }
-	  //then deal with argc == 4 and argc == 6
-	}
+      var = x->swapVar;
     }
   else if(argc == 6)
     {
@@ -1547,7 +2338,34 @@ void polyMath_tilde_swapElement(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_
       x->swapShift = (t_int)atom_getfloat(argv+3);
       x->swapP = atom_getfloat(argv+4);
       x->swapE = atom_getfloat(argv+5);
-
+      return;
+    }
+  else return;
+//allStep filled groupStep groupNum eSize eOff eJoin jSize eAcc1-8 pAcc1-8 eSizeInv denom altOff
+  if(x->grpFixGroup[x->swapSlot] >= 0) groupFixSlot(x, x->swapSlot);
+  x->swapLength = var > 0 ? x->var.len[x->swapSlot + (var - 1) * SLOTS] : x->seq.len[x->swapSlot];
+  if(x->swapLoc < 0 || x->swapLoc >= x->swapLength)
+    {
+      post("You cannot move an element that doesn't exist, i.e. is beyond the sequence! Length = %d, Location = %d",x->swapLength, x->swapLoc);
+    }
+  else if(x->swapLoc + x->swapShift < 0 || x->swapLoc + x->swapShift >= x->swapLength)
+    {
+      post("You cannot shift an element beyond the end of the sequence! Length = %d, newLoc = %d",x->swapLength, x->swapLoc + x->swapShift);
+    }
+  else if(x->swapShift != 0)
+    {
+      undoSave(x, undoNext(x), x->swapSlot, var, x->swapShift < 0 ? x->swapLoc + x->swapShift : x->swapLoc,
+	       (x->swapShift < 0 ? -x->swapShift : x->swapShift) + 1, 0, UNDO_ALL);
+      process = rotateEvents(x, x->swapSlot, var, x->swapLoc, x->swapLoc + x->swapShift);
+      if(!process) post("Element was not moved successfully!");
+    }
+  if(process && x->txApplying) txRegroup(x, x->swapSlot, var, x->swapShift < 0 ? x->swapLoc + x->swapShift : x->swapLoc,
+					 x->swapShift < 0 ? x->swapLoc : x->swapLoc + x->swapShift);
+  else if(process)
+    {
+      x->swapEnd = regroupFrom(x, x->swapSlot, var, x->swapShift < 0 ? x->swapLoc + x->swapShift : x->swapLoc,
+			       x->swapShift < 0 ? x->swapLoc : x->swapLoc + x->swapShift);
+      markDirty(x, x->swapSlot, var, -1, x->swapShift < 0 ? x->swapLoc + x->swapShift : x->swapLoc, x->swapEnd - 1);
     }
 }
 
@@ -1593,6 +2411,7 @@ void polyMath_tilde_initSeqSlot(t_polyMath_tilde *x, t_floatarg newSeqSlot, t_fl
  */
 void polyMath_tilde_seqInSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
+  if(txQueue(x, s, argc, argv)) return;
   x->seqGrpOffset = x->slot * GROUPS;
   x->seqSlotOffset = x->slot * MAXSEQ;
   // incomplete...
@@ -1682,15 +2501,43 @@ void polyMath_tilde_seqInSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_at
 
 */
 
-t_int scramGroup(t_polyMath_tilde *x, t_int slot, t_int sVar, t_int dVar, t_int groupsNum)
+static void nestDrop(t_polyMath_tilde *x, t_int slot, t_int i)
+{
+  t_nestNode *nd = x->nest[slot];
+  t_int c = nd[i].child;
+  t_int next;
+  while(c >= 0)
+    {
+      next = nd[c].next;
+      nestDrop(x, slot, c);
+      c = next;
+    }
+  nd[i].used = 0;
+}
+
+// groupInSlot, groupThisSlot and setGroups rewrite the slot: the tree is dropped
+static void nestClear(t_polyMath_tilde *x, t_int slot)
+{
+  t_int i;
+  for(i = 0; i < x->nestSize[slot]; i++) x->nest[slot][i].used = 0;
+}
+
+static t_int nestRoot(t_polyMath_tilde *x, t_int slot, t_int g)
 {
-  t_int isVar = sVar > 0 ? 1 : 0;
-  t_int sourceOffset = isVar ? slot * GROUPS + sVar * x->GROUPSIZE : slot * GROUPS;
-  t_int destinOffset = slot * GROUPS + dVar * x->GROUPSIZE;
-  t_int seqOffset = isVar ? slot * MAXSEQ + sVar * x->SEQSIZE : slot * MAXSEQ; //x->VARSIZE
-  t_int varOffset = slot * MAXSEQ + dVar * x->SEQSIZE; //x->SEQSIZE
+  t_int i;
+  for(i = 0; i < x->nestSize[slot]; i++) if(x->nest[slot][i].used && x->nest[slot][i].group == g) return(i);
+  return(-1);
 }
 
+// insertGroup (shift 1) and deleteGroup (shift -1) at group g
+static void nestShift(t_polyMath_tilde *x, t_int slot, t_int g, t_int shift)
+{
+  t_nestNode *nd = x->nest[slot];
+  t_int i;
+  if(shift < 0 && (i = nestRoot(x, slot, g)) >= 0) nestDrop(x, slot, i);
+  for(i = 0; i < x->nestSize[slot]; i++)
+    if(nd[i].used && nd[i].group >= 0 && (nd[i].group > g || (shift > 0 && nd[i].group == g))) nd[i].group += shift;
+}
 
 void polyMath_tilde_groupInSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
@@ -1703,6 +2550,10 @@ void polyMath_tilde_groupInSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_
   mark = 0;
   x->grp.nGroups[x->slot] = 0;
   x->seq.len[x->slot] = 0;
+  x->grpMapN[x->slot] = 0; // the group map refers to the old groups
+  groupFixCancel(x, x->slot);
+  nestClear(x, x->slot);
+  undoClearSlot(x, x->slot);
   for(x->c = 0; x->c < argc; x->c += 2)
     {
       x->Gn = atom_getfloat(argv + x->c);
@@ -1794,8 +2645,10 @@ void polyMath_tilde_groupInSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_
       SETFLOAT(&x->seq.jSize[slotOffset + mark], x->Grem);
       mark++;
     }
+  else if(1 - x->cycleDiff <= x->sizeThreshold) x->Icycle++; // 0.99999 is a whole cycle
   else if(x->myBug == 14) post("sizeThreshold = %f, difference = either %f or %f",x->sizeThreshold,x->cycleDiff, 1 - x->cycleDiff);
   x->grp.cycles[x->slot] = x->Icycle;
+  markDirty(x, x->slot, 0, -1, 0, mark - 1);
   
   if(x->myBug == 10)
     {
@@ -1830,6 +2683,11 @@ void polyMath_tilde_groupThisSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc,
   mark = 0;
   x->seq.len[x->thisSlot] = 0;
   x->grp.nGroups[x->thisSlot] = 0;
+  x->grp.gType[x->thisSlot] = 0;
+  x->grpMapN[x->thisSlot] = 0;
+  groupFixCancel(x, x->thisSlot);
+  nestClear(x, x->thisSlot);
+  undoClearSlot(x, x->thisSlot);
   for(x->c = 0; x->c < argc; x->c += 2)
     {
       x->Gn = atom_getfloat(argv + x->c);
@@ -1931,8 +2789,10 @@ void polyMath_tilde_groupThisSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc,
       SETFLOAT(&x->seq.jSize[slotOffset + mark], x->Grem);
       mark++;
     }
+  else if(1 - x->cycleDiff <= x->sizeThreshold) x->Icycle++; // 0.99999 is a whole cycle
   else if(x->myBug == 14) post("sizeThreshold = %f, difference = either %f or %f",x->sizeThreshold,x->cycleDiff, 1 - x->cycleDiff);
   x->grp.cycles[x->thisSlot] = x->Icycle;
+  markDirty(x, x->thisSlot, 0, -1, 0, mark - 1);
   
   if(x->myBug == 10)
     {
@@ -1968,6 +2828,11 @@ void polyMath_tilde_setGroups(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_at
     {
       x->slot = atom_getfloat(argv);
       x->slot = x->slot < 0 ? 0 : x->slot > SLOTS - 1 ? SLOTS - 1 : x->slot;
+      x->grp.gType[x->slot] = 0;
+      x->grpMapN[x->slot] = 0;
+      groupFixCancel(x, x->slot);
+      nestClear(x, x->slot);
+      undoClearSlot(x, x->slot);
       //      x->Eoffset = 0;
       for(x->c = 0; x->c < (argc - 1) / 2; x->c++)
 	//      for(x->c = 0; x->c < (argc - 1) / 2; x->c++)
@@ -2052,1475 +2917,2509 @@ void polyMath_tilde_setGroups(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_at
   //  getVariables(x); // perhaps we might not do this here!
 }
 
-void polyMath_tilde_setP(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+/* LINEAR PHASE
+ * onsetsInSlot slot cycles onset1 onset2 ...: a gType 1 slot from a sorted list of onsets in phase
+ * (0 <= onset < cycles, the first one 0), e.g. the segment starts of a sliced audio file. Each event lasts
+ * until the next onset, the last one until cycles. The slot has one group of all its events, and the
+ * accent lanes are left as they are. At playback the step is found by a binary search of eOff.
+ * quantize slot maxDen: the slot (of either type) again as tuples. Each onset moves to the closest fraction
+ * of its cycle with a denominator up to maxDen (continued fractions), so onsets never drift and the cycles
+ * stay the same. An event is then p/q in lowest terms: events next to each other with the same q make a
+ * group of q-tuples, and p > 1 is a join.
+ */
+// the step of a linear phase slot that holds phase pos: the last onset <= pos
+static t_int onsetFind(t_polyMath_tilde *x, t_int slot, t_float pos)
 {
-  if(argc == 5) // Pslot, step, (p1/2/3/4/5/6/7/8), pNum, pVal
+  t_atom *eOff = x->seq.eOff + slot * MAXSEQ;
+  t_int lo = 0, hi = x->seq.len[slot] - 1, mid;
+  while(lo < hi)
     {
-      x->PSlot = (t_int)atom_getfloat(argv);
-      x->Pac = (t_int)atom_getfloat(argv+2);
-      switch(x->Pac)
-	{
-	case(1):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  if(x->myBug > 0)
-	    {
-	      post("x->Location = %d, PLStep = %d, PSlot = %d", x->PLStep + x->PSlot * MAXSEQ, x->PLStep, x->PSlot);
-	      post("x->PSlot = %d", x->PSlot);
-	    }
-	  SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(2):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(3):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(4):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	case(5):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	case(6):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	case(7):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	case(8):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	default:
-	  break;
-	}
+      mid = (lo + hi + 1) / 2;
+      if(atom_getfloat(&eOff[mid]) <= pos) lo = mid;
+      else hi = mid - 1;
     }
-  else
+  return(lo);
+}
+
+void polyMath_tilde_onsetsInSlot(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, cycles, len, k, so;
+  t_float onset, next, size;
+  if(argc < 3)
     {
-      post("pSet takes a 5 element list: [slotNum, stepNum, p1/2/3/4/5/6/7/8, pNum, pVal");
+      post("onsetsInSlot: you need slot, cycles and at least one onset");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  cycles = (t_int)atom_getfloat(argv + 1);
+  len = argc - 2;
+  if(slot < 0 || slot >= SLOTS)
+    {
+      post("onsetsInSlot: slot must be between 0 and %d", SLOTS - 1);
+      return;
+    }
+  if(cycles < 1 || len >= MAXSEQ)
+    {
+      post("onsetsInSlot: cycles must be >= 1, and there can be up to %d onsets", MAXSEQ - 1);
+      return;
+    }
+  if(atom_getfloat(argv + 2) != 0)
+    {
+      post("onsetsInSlot: the first onset must be 0");
+      return;
+    }
+  for(k = 1; k < len; k++)
+    if(atom_getfloat(argv + 2 + k) <= atom_getfloat(argv + 1 + k))
+      {
+	post("onsetsInSlot: onsets must go up, %f after %f", atom_getfloat(argv + 2 + k), atom_getfloat(argv + 1 + k));
+	return;
+      }
+  if(atom_getfloat(argv + 1 + len) >= (t_float)cycles)
+    {
+      post("onsetsInSlot: onsets must be less than cycles (%d)", cycles);
+      return;
     }
+  groupFixCancel(x, slot);
+  nestClear(x, slot);
+  undoClearSlot(x, slot);
+  so = slot * MAXSEQ;
+  for(k = 0; k < len; k++)
+    {
+      onset = atom_getfloat(argv + 2 + k);
+      next = k + 1 < len ? atom_getfloat(argv + 3 + k) : (t_float)cycles;
+      size = next - onset;
+      SETFLOAT(&x->seq.eOff[so + k], onset);
+      SETFLOAT(&x->seq.eSize[so + k], size);
+      SETFLOAT(&x->seq.eSizeInv[so + k], 1 / size);
+      SETFLOAT(&x->seq.denom[so + k], 1 / size);
+      SETFLOAT(&x->seq.allStep[so + k], (t_float)k);
+      SETFLOAT(&x->seq.groupStep[so + k], (t_float)k);
+      SETFLOAT(&x->seq.groupNum[so + k], 0);
+      SETFLOAT(&x->seq.eJoin[so + k], 1);
+      SETFLOAT(&x->seq.jSize[so + k], size);
+    }
+  SETFLOAT(&x->grp.n[slot * GROUPS], (t_float)len);
+  SETFLOAT(&x->grp.d[slot * GROUPS], (t_float)len / (t_float)cycles);
+  SETFLOAT(&x->grp.offset[slot * GROUPS], 0);
+  SETFLOAT(&x->grp.size[slot * GROUPS], (t_float)cycles);
+  SETFLOAT(&x->grp.sizeInv[slot * GROUPS], 1 / (t_float)cycles);
+  x->grp.gStart[slot * GROUPS] = 0;
+  x->grp.nGroups[slot] = 1;
+  x->grp.isUnFilled[slot] = 0;
+  x->grp.cycles[slot] = cycles;
+  x->grp.gType[slot] = 1;
+  x->seq.len[slot] = len;
+  x->grpMapN[slot] = 0;
+  if(x->genSlot == slot) x->genSlot = -1;
+  markDirty(x, slot, 0, -1, 0, len - 1);
 }
 
-void polyMath_tilde_setPOnly(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+// groupThisSlot on any slot, without moving the slot that thisSlot points to
+static void groupsInto(t_polyMath_tilde *x, t_int slot, t_int argc, t_atom *argv)
 {
-  if(argc == 4) // Pslot, step, (p1/2/3/4), pNum
+  t_int keep = x->thisSlot;
+  x->thisSlot = slot;
+  x->Goff = 0;
+  polyMath_tilde_groupThisSlot(x, gensym("groupThisSlot"), argc, argv);
+  x->thisSlot = keep;
+  if(x->genSlot == slot) x->genSlot = -1;
+}
+
+// the fraction num/den closest to v with den <= maxDen: the last convergent of the continued fraction of v
+// that fits, or the semiconvergent below the bound if that is closer
+static void bestRatio(t_float v, t_int maxDen, t_int *num, t_int *den)
+{
+  double f = v, a;
+  long h0 = 0, h1 = 1, k0 = 1, k1 = 0, h2, k2, t;
+  t_int i;
+  for(i = 0; i < 64; i++)
     {
-      x->PSlot = (t_int)atom_getfloat(argv);
-      x->Pac = (t_int)atom_getfloat(argv+2);
-      switch(x->Pac)
+      a = floor(f);
+      k2 = (long)a * k1 + k0;
+      if(k2 > maxDen)
 	{
-	case(1):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(2):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  if(x->myBug > 0)
+	  t = (maxDen - k0) / k1;
+	  if(fabs((double)(h0 + t * h1) / (double)(k0 + t * k1) - v) < fabs((double)h1 / (double)k1 - v))
 	    {
-	      post("x->Location = %d",x->PLStep + x->PSlot * MAXSEQ);
-	      post("x->PSlot = %d",x->PSlot);
+	      h1 = h0 + t * h1;
+	      k1 = k0 + t * k1;
 	    }
-	  SETFLOAT(&x->seq.pAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(3):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(4):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(5):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(6):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(7):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	case(8):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  SETFLOAT(&x->seq.pAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
-	  break;
-	default:
 	  break;
 	}
+      h2 = (long)a * h1 + h0;
+      h0 = h1; h1 = h2;
+      k0 = k1; k1 = k2;
+      if(f - a < 1e-6) break;
+      f = 1 / (f - a);
     }
-  else
+  *num = (t_int)h1;
+  *den = (t_int)k1;
+}
+
+static long gcdLong(long a, long b)
+{
+  long t;
+  while(b)
     {
-      post("pSetOnly takes a 4 element list: [slotNum, stepNum, p1/2/3/4/5/6/7/8, pNum");
+      t = a % b;
+      a = b;
+      b = t;
     }
+  return(a);
 }
 
-void polyMath_tilde_setVOnly(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+void polyMath_tilde_quantize(t_polyMath_tilde *x, t_floatarg fslot, t_floatarg fden)
 {
-  if(argc == 4) // Pslot, step, (p1/2/3/4), vNum
+  t_int slot = (t_int)fslot;
+  t_int maxDen = (t_int)fden;
+  t_int len, cycles, k, f, last, so, events, groups, num, den;
+  long *on, *od, *p, *q, *head, g, nn, nd;
+  t_atom *list, *lane, *tmp;
+  t_float o;
+  size_t bytes;
+  if(slot < 0 || slot >= SLOTS || maxDen < 1)
     {
-      x->PSlot = (t_int)atom_getfloat(argv);
-      x->Pac = (t_int)atom_getfloat(argv+2);
-      switch(x->Pac)
-	{
-	case(1):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(2):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  if(x->myBug > 0)
-	    {
-	      post("x->Location = %d",x->PLStep + x->PSlot * MAXSEQ);
-	      post("x->PSlot = %d",x->PSlot);
-	    }
-	  //SETFLOAT(&x->seq.pAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(3):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(4):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(5):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(6):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(7):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	case(8):
-	  x->PLStep = (t_int)atom_getfloat(argv+1);
-	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
-	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  SETFLOAT(&x->seq.eAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
-	  break;
-	default:
-	  break;
-	}
+      post("quantize: slot 0 - %d, maxDen >= 1", SLOTS - 1);
+      return;
     }
-  else
+  maxDen = maxDen > MAXSEQ ? MAXSEQ : maxDen;
+  if(x->grpFixGroup[slot] >= 0) groupFixSlot(x, slot);
+  len = x->seq.len[slot];
+  cycles = x->grp.cycles[slot];
+  if(len < 1) return;
+  so = slot * MAXSEQ;
+  bytes = len * 5 * sizeof(long) + len * 3 * sizeof(t_atom);
+  on = (long *)getbytes(bytes);
+  if(!on)
     {
-      post("vSetOnly takes a 4 element list: [slotNum, stepNum, p1/2/3/4/5/6/7/8, pVal");
+      post("quantize: out of memory");
+      return;
+    }
+  od = on + len;
+  p = od + len;
+  q = p + len;
+  head = q + len;
+  list = (t_atom *)(head + len);
+  tmp = list + len * 2;
+  // each onset to the nearest whole cycle + num/den, den <= maxDen. Onsets that land on the one before
+  // (or on the end) are dropped and their time goes to the event before them
+  on[0] = 0;
+  od[0] = 1;
+  head[0] = 0;
+  for(k = 1, last = 0; k < len; k++)
+    {
+      o = atom_getfloat(&x->seq.eOff[so + k]);
+      bestRatio(o - floor(o), maxDen, &num, &den);
+      on[k] = (long)floor(o) * den + num;
+      od[k] = den;
+      if(on[k] * od[last] <= on[last] * od[k] || on[k] >= (long)cycles * od[k]) head[k] = -1;
+      else last = k;
+    }
+  // sizes are the exact differences of the quantized onsets, p/q in lowest terms
+  events = groups = 0;
+  for(k = 0; k < len; k++)
+    {
+      if(head[k] < 0) continue;
+      for(last = k + 1; last < len && head[last] < 0; last++);
+      nn = last < len ? on[last] : cycles;
+      nd = last < len ? od[last] : 1;
+      p[k] = nn * od[k] - on[k] * nd;
+      q[k] = od[k] * nd;
+      g = gcdLong(p[k], q[k]);
+      p[k] /= g;
+      q[k] /= g;
+      head[k] = events;
+      events += p[k];
+      if(groups == 0 || (t_int)atom_getfloat(&list[groups * 2 - 1]) != q[k])
+	{
+	  SETFLOAT(&list[groups * 2], 0);
+	  SETFLOAT(&list[groups * 2 + 1], (t_float)q[k]);
+	  groups++;
+	}
+      SETFLOAT(&list[groups * 2 - 2], atom_getfloat(&list[groups * 2 - 2]) + (t_float)p[k]);
     }
+  if(events >= MAXSEQ || groups >= GROUPS)
+    {
+      post("quantize: %d events in %d groups do not fit, try a smaller maxDen", events, groups);
+      freebytes(on, bytes);
+      return;
+    }
+  // the accents go with their events
+  for(f = 8; f < 24; f++)
+    {
+      lane = eventField(x, 0, f) + so;
+      memcpy(tmp, lane, len * sizeof(t_atom));
+      for(k = 0; k < len; k++) if(head[k] >= 0) lane[head[k]] = tmp[k];
+    }
+  groupsInto(x, slot, groups * 2, list);
+  for(k = 0; k < len; k++)
+    if(head[k] >= 0 && p[k] > 1) SETFLOAT(&x->seq.eJoin[so + head[k]], (t_float)p[k]);
+  markDirty(x, slot, 0, 4, 0, events - 1);
+  if(x->myBug == 10) post("quantize: %d events -> %d events in %d groups", len, events, groups);
+  freebytes(on, bytes);
 }
 
-/* data types:
- * dType --- data
- * 99    --- {slot, variation}
- * 98    --- {slot, length}
+/* PATTERN ALGEBRA
+ * concat dst src1 src2 ...: the groups of the sources one after the other
+ * interleave dst a b: a group of a, a group of b, a group of a ... then the rest of the longer one
+ * repeat dst src n: src n times
+ * The fill group of a source is kept as a group of its own, so each source keeps its whole cycles and
+ * groups stay in bar. The tables of dst are built in one pass from a list of (slot, group) pairs, and dst
+ * may be one of the sources. The accents, joins and denominators of each event go with it.
  */
-
-void polyMath_tilde_slot(t_polyMath_tilde *x, t_floatarg f)
+// checks a source slot and brings its groups up to date: 0 = bad slot
+static t_int algebraSource(t_polyMath_tilde *x, const char *name, t_int slot)
 {
-  x->slot = f < 0 ? 0 : f >= SLOTS ? SLOTS - 1 : (t_int)f;
-  //SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
-  //x->outList[0] = (t_float)x->slot;
-  //x->outList[1] = (t_float)x->variation;
-  SETFLOAT(&x->outList[0], (t_float)x->slot);
-  SETFLOAT(&x->outList[1], (t_float)x->variation);
-  outlet_float(x->dType, 99);
-  outlet_list(x->dataOut, gensym("list"), 2, x->outList);
+  if(slot < 0 || slot >= SLOTS)
+    {
+      post("%s: slot must be between 0 and %d", name, SLOTS - 1);
+      return(0);
+    }
+  if(x->grpFixGroup[slot] >= 0) groupFixSlot(x, slot);
+  if(x->seq.len[slot] < 1 || x->grp.nGroups[slot] < 1)
+    {
+      post("%s: slot %d is empty", name, slot);
+      return(0);
+    }
+  return(1);
 }
 
-void polyMath_tilde_slotLen(t_polyMath_tilde *x, t_floatarg f)
+static void algebraBuild(t_polyMath_tilde *x, const char *name, t_int dst, t_int *src, t_int *group, t_int count)
 {
-  x->getSlotLen = f < 0 ? 0 : f >= SLOTS ? SLOTS - 1 : (t_int)f;
-  //t_int isLength, t_int getSlot;
-  x->isLength = x->seq.len[x->getSlotLen];
-  SETFLOAT(&x->outList[0], (t_float)x->getSlotLen);
-  SETFLOAT(&x->outList[1], (t_float)x->isLength);
-  outlet_float(x->dType, 98);
-  outlet_list(x->dataOut, gensym("list"), 2, x->outList);  
+  t_int so = dst * MAXSEQ;
+  t_int go = dst * GROUPS;
+  t_int total, linear, i, f, e, n, start;
+  t_atom *ev, *gr;
+  size_t bytes;
+  for(i = 0, total = 0, linear = 1; i < count; i++)
+    {
+      total += (t_int)atom_getfloatarg(src[i] * GROUPS + group[i], x->GROUPSIZE, x->grp.n);
+      linear &= x->grp.gType[src[i]] == 1;
+    }
+  if(total >= MAXSEQ || count >= GROUPS)
+    {
+      post("%s: %d events in %d groups do not fit in a slot", name, total, count);
+      return;
+    }
+  bytes = (EVENTLIST * total + 4 * count) * sizeof(t_atom);
+  ev = (t_atom *)getbytes(bytes);
+  if(!ev)
+    {
+      post("%s: out of memory", name);
+      return;
+    }
+  gr = ev + EVENTLIST * total;
+  for(i = 0, e = 0; i < count; i++)
+    {
+      n = (t_int)atom_getfloatarg(src[i] * GROUPS + group[i], x->GROUPSIZE, x->grp.n);
+      start = src[i] * MAXSEQ + x->grp.gStart[src[i] * GROUPS + group[i]];
+      for(f = 0; f < EVENTLIST; f++) memcpy(ev + f * total + e, eventField(x, 0, f) + start, n * sizeof(t_atom));
+      gr[i * 4] = x->grp.n[src[i] * GROUPS + group[i]];
+      gr[i * 4 + 1] = x->grp.d[src[i] * GROUPS + group[i]];
+      gr[i * 4 + 2] = x->grp.size[src[i] * GROUPS + group[i]];
+      gr[i * 4 + 3] = x->grp.sizeInv[src[i] * GROUPS + group[i]];
+      e += n;
+    }
+  for(f = 0; f < EVENTLIST; f++) memcpy(eventField(x, 0, f) + so, ev + f * total, total * sizeof(t_atom));
+  for(i = 0; i < count; i++)
+    {
+      x->grp.n[go + i] = gr[i * 4];
+      x->grp.d[go + i] = gr[i * 4 + 1];
+      x->grp.size[go + i] = gr[i * 4 + 2];
+      x->grp.sizeInv[go + i] = gr[i * 4 + 3];
+    }
+  freebytes(ev, bytes);
+  x->seq.len[dst] = total;
+  x->grp.nGroups[dst] = count;
+  x->grp.isUnFilled[dst] = 0;
+  x->grp.gType[dst] = linear;
+  x->grpMapN[dst] = 0;
+  if(x->genSlot == dst) x->genSlot = -1;
+  nestClear(x, dst);
+  undoClearSlot(x, dst);
+  // starts, offsets, group numbers, cycles and the fill group of dst
+  groupMarkStale(x, dst, 0, 0);
+  groupFixSlot(x, dst);
+  if(x->myBug == 10) post("%s: slot %d has %d events in %d groups, %d cycles", name, dst, total, count, x->grp.cycles[dst]);
 }
 
-//useless: lastLen
-void polyMath_tilde_jumpNext(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+void polyMath_tilde_concat(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
-  //t_int lastOffset, nextOffset;
-  x->validJumpState = 0;
-  //lastOffset = x->slot * MAXSEQ; nextOffset = x->slot * MAXSEQ; // just initialize in case no args presented
-  if(argc == 2)
+  t_int src[GROUPS], group[GROUPS];
+  t_int dst, slot, i, g, count = 0;
+  if(argc < 2)
     {
-      x->lastVar = x->varPerf;
-      x->lastSlot = x->slot;
-      x->nextSlot = (t_int)atom_getfloat(argv);
-      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot; 
-      x->nextVar = (t_int)atom_getfloat(argv+1);
-      x->nextVar = x->nextVar < 0 ? 0 : x->nextVar >= VARIATIONS ? VARIATIONS : x->nextVar;
-      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
-      else x->JlastOffset = x->lastSlot * MAXSEQ;
-      if(x->nextVar > 0)
-	{
-	  x->JnextOffset = x->nextSlot * MAXSEQ + x->varPerf * x->SEQSIZE;
-	  if(x->myBug == 10) post("x->JnextOffset = %d, x->nextSlot = %d, x->varPerf = %d",x->JnextOffset,x->nextSlot,x->varPerf);
-	}
-      else x->JnextOffset = x->nextSlot * MAXSEQ;
-      if(x->nextVar == 0)
+      post("concat: you need dst and at least one src");
+      return;
+    }
+  dst = (t_int)atom_getfloat(argv);
+  if(dst < 0 || dst >= SLOTS)
+    {
+      post("concat: slot must be between 0 and %d", SLOTS - 1);
+      return;
+    }
+  for(i = 1; i < argc; i++)
+    {
+      slot = (t_int)atom_getfloat(argv + i);
+      if(!algebraSource(x, "concat", slot)) return;
+      for(g = 0; g < x->grp.nGroups[slot]; g++)
 	{
-	  if(x->seq.len[x->nextSlot] == 0)
-	    {
-	      post("Invalid jump state - sequence not defined {:-(");
-	      x->validJumpState = 0;
-	    }
-	  else
+	  if(count == GROUPS)
 	    {
-	      post("Jumping to slot %d",x->nextSlot);
-	      x->validJumpState = 1;
+	      post("concat: more than %d groups", GROUPS - 1);
+	      return;
 	    }
+	  src[count] = slot;
+	  group[count++] = g;
 	}
-      else
-	{
-	  if(x->var.variations[x->slot + (x->nextVar - 1) * SLOTS] == 0)
-	    {
-	      post("Invalid jump state - variation not defined [;-(");
-	      x->validJumpState = 0;
-	    }
-	  else
-	    {
-	      post("Jumping to variation %d of slot %d",x->nextVar,x->nextSlot);
-	      x->validJumpState = 1;
-	    }
-	}    
     }
-  else if(argc == 1)
+  algebraBuild(x, "concat", dst, src, group, count);
+}
+
+void polyMath_tilde_interleave(t_polyMath_tilde *x, t_floatarg fdst, t_floatarg fa, t_floatarg fb)
+{
+  t_int src[GROUPS], group[GROUPS];
+  t_int dst = (t_int)fdst, a = (t_int)fa, b = (t_int)fb;
+  t_int g, count = 0;
+  if(dst < 0 || dst >= SLOTS || !algebraSource(x, "interleave", a) || !algebraSource(x, "interleave", b))
     {
-      x->nextVar = 0;
-      x->lastVar = x->varPerf;
-      x->lastSlot = x->slot;
-      x->nextSlot = (t_int)atom_getfloat(argv);
-      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot;
-      if(x->myBug == 10) post("nextSlot = %d",x->nextSlot);
-      x->nextVar = 0;
-      //x->varPerf = 0;
-      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
-      else x->JlastOffset = x->lastSlot * MAXSEQ;
-      x->JnextOffset = x->nextSlot * MAXSEQ;
-      if(x->seq.len[x->nextSlot] == 0)
+      if(dst < 0 || dst >= SLOTS) post("interleave: slot must be between 0 and %d", SLOTS - 1);
+      return;
+    }
+  if(x->grp.nGroups[a] + x->grp.nGroups[b] >= GROUPS)
+    {
+      post("interleave: more than %d groups", GROUPS - 1);
+      return;
+    }
+  for(g = 0; g < x->grp.nGroups[a] || g < x->grp.nGroups[b]; g++)
+    {
+      if(g < x->grp.nGroups[a])
 	{
-	  post("Invalid jump state - sequence not defined {:-(");
-	  x->validJumpState = 0;
+	  src[count] = a;
+	  group[count++] = g;
 	}
-      else
+      if(g < x->grp.nGroups[b])
 	{
-	  post("Jumping to slot %d",x->nextSlot);
-	  x->validJumpState = 1;
-	  x->varPerf = 0;
+	  src[count] = b;
+	  group[count++] = g;
 	}
     }
-  if(x->validJumpState)
+  algebraBuild(x, "interleave", dst, src, group, count);
+}
+
+void polyMath_tilde_repeat(t_polyMath_tilde *x, t_floatarg fdst, t_floatarg fsrc, t_floatarg fn)
+{
+  t_int src[GROUPS], group[GROUPS];
+  t_int dst = (t_int)fdst, slot = (t_int)fsrc, n = (t_int)fn;
+  t_int i, g, count = 0;
+  if(dst < 0 || dst >= SLOTS || !algebraSource(x, "repeat", slot))
     {
-      x->varTest = x->nextVar;
-      x->zeroNextSlot = 0;
-      x->zeroNextVar = 0;
-      x->changeSlot = 0;
-      x->changeVar = 0;
-      if(x->nextVar == 0)
+      if(dst < 0 || dst >= SLOTS) post("repeat: slot must be between 0 and %d", SLOTS - 1);
+      return;
+    }
+  if(n < 1 || n * x->grp.nGroups[slot] >= GROUPS)
+    {
+      post("repeat: n must be >= 1, and n * %d groups fewer than %d", x->grp.nGroups[slot], GROUPS);
+      return;
+    }
+  for(i = 0; i < n; i++)
+    for(g = 0; g < x->grp.nGroups[slot]; g++)
+      {
+	src[count] = slot;
+	group[count++] = g;
+      }
+  algebraBuild(x, "repeat", dst, src, group, count);
+}
+
+/* RHYTHM GENERATORS
+ * euclid slot k n d [rotate]: k onsets spread as evenly as they go over n steps of 1/d (Bjorklund),
+ * rotated left by rotate steps. Each onset starts a group that lasts until the next one, so E(3, 8) is
+ * 3/8 3/8 2/8; if the rotation puts steps before the first onset, they make a group of their own.
+ * additive slot d n1 n2 ...: groups of n1, n2 ... steps of 1/d, e.g. additive 0 8 3 3 2
+ * Both write the slot as groupThisSlot does, then the accent lane 1 value (eAcc1): 1 on the onsets,
+ * 0 on the other steps. Nothing is allocated, so they can be sent every bar.
+ */
+// eAcc1 over the whole slot: 1 at the first event of each group from group first on
+static void rhythmOnsets(t_polyMath_tilde *x, t_int slot, t_int first)
+{
+  t_int so = slot * MAXSEQ;
+  t_int len = x->seq.len[slot];
+  t_int k, g;
+  for(k = 0; k < len; k++) SETFLOAT(&x->seq.eAcc1[so + k], 0);
+  for(g = first; g < x->grp.nGroups[slot]; g++)
+    if(x->grp.gStart[slot * GROUPS + g] < len) SETFLOAT(&x->seq.eAcc1[so + x->grp.gStart[slot * GROUPS + g]], 1);
+  markDirty(x, slot, 0, 12, 0, len - 1);
+}
+
+void polyMath_tilde_euclid(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  char a[MAXSEQ], b[MAXSEQ], t[MAXSEQ];
+  t_atom list[GROUPS * 2];
+  t_int slot, k, n, rotate, na, nb, la, lb, m, i, j, step, run, groups;
+  t_float d;
+  if(argc < 4)
+    {
+      post("euclid: you need slot, k, n, d [rotate]");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  k = (t_int)atom_getfloat(argv + 1);
+  n = (t_int)atom_getfloat(argv + 2);
+  d = atom_getfloat(argv + 3);
+  rotate = argc > 4 ? (t_int)atom_getfloat(argv + 4) : 0;
+  if(slot < 0 || slot >= SLOTS)
+    {
+      post("euclid: slot must be between 0 and %d", SLOTS - 1);
+      return;
+    }
+  if(n < 1 || n >= MAXSEQ || k < 1 || k > n || k > GROUPS - 2 || d <= 0)
+    {
+      post("euclid: 1 <= k <= n, n < %d, k < %d, d > 0", MAXSEQ, GROUPS - 1);
+      return;
+    }
+  // na copies of pattern a (la steps) followed by nb copies of b: each round pairs an a with a b
+  a[0] = 1; la = 1; na = k;
+  b[0] = 0; lb = 1; nb = n - k;
+  while(nb > 1)
+    {
+      m = na < nb ? na : nb;
+      if(na > nb)
 	{
-	  x->jumpSlotAtEnd = 1;	
-	  x->jumpVarAtEnd = 0;
+	  memcpy(t, a, la);
+	  memcpy(a + la, b, lb);
+	  memcpy(b, t, la);
+	  la += lb;
+	  lb = la - lb;
 	}
       else
 	{
-	  x->jumpVarAtEnd = 1;
-	  x->jumpSlotAtEnd = 0;
+	  memcpy(a + la, b, lb);
+	  la += lb;
 	}
+      nb = (na > nb ? na : nb) - m;
+      na = m;
     }
+  for(i = 0, step = 0; i < na; i++, step += la) memcpy(t + step, a, la);
+  for(i = 0; i < nb; i++, step += lb) memcpy(t + step, b, lb);
+  // a group from each onset to the next
+  rotate = ((rotate % n) + n) % n;
+  groups = 0;
+  for(i = 0, run = 0; i < n; i++)
+    {
+      j = t[(i + rotate) % n];
+      if(j && run > 0)
+	{
+	  SETFLOAT(&list[groups * 2], (t_float)run);
+	  SETFLOAT(&list[groups * 2 + 1], d);
+	  groups++;
+	  run = 0;
+	}
+      run++;
+    }
+  SETFLOAT(&list[groups * 2], (t_float)run);
+  SETFLOAT(&list[groups * 2 + 1], d);
+  groups++;
+  groupsInto(x, slot, groups * 2, list);
+  rhythmOnsets(x, slot, t[rotate] ? 0 : 1);
 }
 
-void polyMath_tilde_jumpTo(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv) // Jan 17th 2018
+void polyMath_tilde_additive(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
-  //t_int lastOffset, nextOffset;
-  //t_int lastLen, nextLen, iWrap, nextFlag, locateFlag;
-  //t_float lastCycle, nextCycle;
-  //t_float sizeLast, offLast,
-  //  sizeNext, offNext, wrapCycle;
-  x->validJumpState = 0;
-  //lastOffset = x->slot * MAXSEQ; x->JnextOffset = x->slot * MAXSEQ; // just initialize in case no args presented
-  if(argc == 2)
+  t_atom list[GROUPS * 2];
+  t_int slot, i, n, total;
+  t_float d;
+  if(argc < 3)
     {
-      x->lastVar = x->varPerf;
-      x->lastSlot = x->slot;
-      x->nextSlot = (t_int)atom_getfloat(argv);
-      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot; 
-      x->nextVar = (t_int)atom_getfloat(argv+1);
-      x->nextVar = x->nextVar < 0 ? 0 : x->nextVar >= VARIATIONS ? VARIATIONS - 1: x->nextVar;
-      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
-      else x->JlastOffset = x->lastSlot * MAXSEQ;
-      if(x->nextVar > 0)
-	{//should this be x->varPerf or x->nextVar?
-	  x->varPerf = x->nextVar - 1;
-	  x->varTest = x->nextVar;
-	  x->JnextOffset = x->nextSlot * MAXSEQ + x->varPerf * x->SEQSIZE;
-	  //x->JnextOffset = x->nextSlot * MAXSEQ + (x->nextVar - 1) * x->SEQSIZE;
-	  if(x->myBug == 10) post("x->JnextOffset = %d, x->nextSlot = %d, x->varPerf = %d", x->JnextOffset, x->nextSlot, x->varPerf);
-	}
-      else x->JnextOffset = x->nextSlot * MAXSEQ;
-      if(x->nextVar == 0)
+      post("additive: you need slot, d and at least one group");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  d = atom_getfloat(argv + 1);
+  if(slot < 0 || slot >= SLOTS || d <= 0 || argc - 2 >= GROUPS)
+    {
+      post("additive: slot 0 - %d, d > 0, up to %d groups", SLOTS - 1, GROUPS - 2);
+      return;
+    }
+  for(i = 2, total = 0; i < argc; i++)
+    {
+      n = (t_int)atom_getfloat(argv + i);
+      if(n < 1)
 	{
-	  if(x->seq.len[x->nextSlot] == 0)
-	    {
-	      post("Invalid jump state - sequence not defined {:-(");
-	      x->validJumpState = 0;
-	    }
-	  else
-	    {
-	      post("Jumping to slot %d",x->nextSlot);
-	      x->varTest = x->nextVar;
-	      x->validJumpState = 1;
-	    }
+	  post("additive: each group needs at least 1 step");
+	  return;
 	}
-      else
-	{
-	  //x->var.variations[x->slot + x->thisVar * SLOTS] = 1;
-	  if(x->myBug == 9)
-	    {
-	      post("x->var.variations: %d", x->var.variations[x->slot + (x->nextVar - 1) * SLOTS]);
-	      post("x->var.variations: %d", x->var.variations[x->slot + x->nextVar * SLOTS]);
-	      //post("x->var.variations: %d", x->var.variations[x->slot + (x->nextVar + 1) * SLOTS]);
+      total += n;
+      SETFLOAT(&list[(i - 2) * 2], (t_float)n);
+      SETFLOAT(&list[(i - 2) * 2 + 1], d);
+    }
+  if(total >= MAXSEQ)
+    {
+      post("additive: %d steps, a slot holds %d", total, MAXSEQ - 1);
+      return;
+    }
+  groupsInto(x, slot, (argc - 2) * 2, list);
+  rhythmOnsets(x, slot, 0);
+}
 
-	    }
-	  if(x->var.variations[x->slot + (x->nextVar - 1) * SLOTS] == 0)
-	    {
-	      post("Invalid jump state - variation not defined [;-(");
-	      x->validJumpState = 0;
-	    }
-	  else
-	    {
-	      x->varPerf = x->nextVar > 0 ? x->nextVar - 1 : 0;
-	      post("Jumping to variation %d of slot %d",x->nextVar,x->nextSlot);
-	      x->validJumpState = 1;
-	      x->varTest = x->nextVar;
-	    }
-	}    
+// move the group arrays of groups g... of a slot by shift (+1 or -1)
+static void groupShift(t_polyMath_tilde *x, t_int slot, t_int g, t_int shift)
+{
+  t_int go = slot * GROUPS;
+  t_int count = x->grp.nGroups[slot] - g - (shift < 0 ? 1 : 0);
+  t_int from = shift < 0 ? g + 1 : g;
+  if(count <= 0) return;
+  memmove(x->grp.n + go + from + shift, x->grp.n + go + from, count * sizeof(t_atom));
+  memmove(x->grp.d + go + from + shift, x->grp.d + go + from, count * sizeof(t_atom));
+  memmove(x->grp.size + go + from + shift, x->grp.size + go + from, count * sizeof(t_atom));
+  memmove(x->grp.sizeInv + go + from + shift, x->grp.sizeInv + go + from, count * sizeof(t_atom));
+  memmove(x->grp.offset + go + from + shift, x->grp.offset + go + from, count * sizeof(t_atom));
+  memmove(x->grp.gStart + go + from + shift, x->grp.gStart + go + from, count * sizeof(t_int));
+}
+
+// insertGroup slot index n d: insert an n/d group before group index (index = nGroups appends)
+void polyMath_tilde_insertGroup(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  t_int slot, g, n, e, len, f, k;
+  t_float d, eSize;
+  t_atom *a;
+  if(argc != 4)
+    {
+      post("insertGroup: slot index numerator denominator");
+      return;
     }
-  else if(argc == 1)
+  slot = (t_int)atom_getfloat(argv);
+  g = (t_int)atom_getfloat(argv + 1);
+  n = (t_int)atom_getfloat(argv + 2);
+  d = atom_getfloat(argv + 3);
+  if(slot < 0 || slot >= SLOTS)
     {
-      x->nextVar = 0;
-      x->lastVar = x->varPerf;
-      x->lastSlot = x->slot;
-      x->nextSlot = (t_int)atom_getfloat(argv);
-      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot;
-      if(x->myBug == 10) post("nextSlot = %d",x->nextSlot);
-      x->nextVar = 0;
-      //x->varPerf = 0;
-      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
-      else x->JlastOffset = x->lastSlot * MAXSEQ;
-      x->JnextOffset = x->nextSlot * MAXSEQ;
-      if(x->seq.len[x->nextSlot] == 0)
+      post("insertGroup: slot is out of range: %d", slot);
+      return;
+    }
+  len = x->seq.len[slot];
+  if(g < 0 || g > x->grp.nGroups[slot] - fillerGroup(x, slot))
+    {
+      post("insertGroup: slot %d has %d groups, index %d is out of range", slot, x->grp.nGroups[slot] - fillerGroup(x, slot), g);
+      return;
+    }
+  if(n <= 0 || d <= 0)
+    {
+      post("Error: numerator and denominator must both be > 0");
+      return;
+    }
+  if(len + n > MAXSEQ || x->grp.nGroups[slot] + 1 > GROUPS)
+    {
+      post("insertGroup: slot %d is full", slot);
+      return;
+    }
+  // where the group starts: the stale starts after an earlier edit are fixed first
+  if(x->grpFixGroup[slot] >= 0 && g >= x->grpFixGroup[slot]) groupFixSlot(x, slot);
+  e = g < x->grp.nGroups[slot] ? x->grp.gStart[slot * GROUPS + g] : len;
+  for(f = 0; f < EVENTLIST; f++)
+    {
+      a = eventField(x, 0, f) + slot * MAXSEQ;
+      memmove(a + e + n, a + e, (len - e) * sizeof(t_atom));
+      for(k = e; k < e + n; k++) SETFLOAT(&a[k], 0);
+    }
+  eSize = 1 / d;
+  for(k = 0; k < n; k++)
+    {
+      SETFLOAT(&x->seq.eSize[slot * MAXSEQ + e + k], eSize);
+      SETFLOAT(&x->seq.eSizeInv[slot * MAXSEQ + e + k], d);
+      SETFLOAT(&x->seq.denom[slot * MAXSEQ + e + k], d);
+      SETFLOAT(&x->seq.groupStep[slot * MAXSEQ + e + k], (t_float)k);
+      SETFLOAT(&x->seq.eJoin[slot * MAXSEQ + e + k], 1);
+      SETFLOAT(&x->seq.jSize[slot * MAXSEQ + e + k], eSize);
+    }
+  groupShift(x, slot, g, 1);
+  SETFLOAT(&x->grp.n[slot * GROUPS + g], (t_float)n);
+  SETFLOAT(&x->grp.d[slot * GROUPS + g], d);
+  SETFLOAT(&x->grp.size[slot * GROUPS + g], eSize * (t_float)n);
+  SETFLOAT(&x->grp.sizeInv[slot * GROUPS + g], d / (t_float)n);
+  x->grp.gStart[slot * GROUPS + g] = e;
+  x->grp.nGroups[slot]++;
+  x->grp.isUnFilled[slot] = 0;
+  x->seq.len[slot] = len + n;
+  if(x->genSlot == slot) x->genSlot = -1;
+  x->grpMapN[slot] = 0; // the group map refers to the old group indices
+  nestShift(x, slot, g, 1);
+  undoClearSlot(x, slot);
+  groupMarkStale(x, slot, g, e);
+}
+
+// deleteGroup slot index: remove group index and its events
+void polyMath_tilde_deleteGroup(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  t_int slot, g, n, e, len, f;
+  t_atom *a;
+  if(argc != 2)
+    {
+      post("deleteGroup: slot index");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  g = (t_int)atom_getfloat(argv + 1);
+  if(slot < 0 || slot >= SLOTS)
+    {
+      post("deleteGroup: slot is out of range: %d", slot);
+      return;
+    }
+  if(g < 0 || g >= x->grp.nGroups[slot] - fillerGroup(x, slot))
+    {
+      post("deleteGroup: slot %d has %d groups, index %d is out of range", slot, x->grp.nGroups[slot] - fillerGroup(x, slot), g);
+      return;
+    }
+  if(x->grp.nGroups[slot] - fillerGroup(x, slot) == 1)
+    {
+      post("deleteGroup: the last group of a slot cannot be deleted");
+      return;
+    }
+  if(x->grpFixGroup[slot] >= 0 && g + 1 >= x->grpFixGroup[slot]) groupFixSlot(x, slot); // grpEvents reads the next start
+  len = x->seq.len[slot];
+  e = x->grp.gStart[slot * GROUPS + g];
+  n = grpEvents(x, slot, g);
+  for(f = 0; f < EVENTLIST; f++)
+    {
+      a = eventField(x, 0, f) + slot * MAXSEQ;
+      memmove(a + e, a + e + n, (len - e - n) * sizeof(t_atom));
+    }
+  groupShift(x, slot, g, -1);
+  x->grp.nGroups[slot]--;
+  x->seq.len[slot] = len - n;
+  if(x->genSlot == slot) x->genSlot = -1;
+  x->grpMapN[slot] = 0;
+  nestShift(x, slot, g, -1);
+  undoClearSlot(x, slot);
+  groupMarkStale(x, slot, g, e);
+}
+
+/* NEST / UNNEST
+ * nest slot group at span n [at span n ...]: in the group, replace span steps from step at with n equal
+ * steps, e.g. "nest 0 2 0 2 3" puts a 3 over the first two 5ths of a 5/16 group. Each further triple works
+ * inside the node made (or found) by the one before it, so tuplets can be nested to any depth; a triple
+ * that names an existing node with a different n replaces it and drops what was nested inside it.
+ * unnest slot group [at span ...]: remove the node at the end of the path (only the group: all of it).
+ * Only the edited group is compiled back into the flat event table; the events after it are moved and
+ * their offsets fixed up lazily, as for insertGroup.
+ */
+static t_int nestAlloc(t_polyMath_tilde *x, t_int slot)
+{
+  t_int i, size;
+  for(i = 0; i < x->nestSize[slot]; i++) if(!x->nest[slot][i].used) break;
+  if(i == x->nestSize[slot])
+    {
+      size = x->nestSize[slot] ? x->nestSize[slot] * 2 : 16;
+      x->nest[slot] = x->nestSize[slot] ? (t_nestNode *)resizebytes(x->nest[slot], x->nestSize[slot] * sizeof(t_nestNode), size * sizeof(t_nestNode))
+	: (t_nestNode *)getbytes(size * sizeof(t_nestNode));
+      if(x->nest[slot] == 0)
 	{
-	  post("Invalid jump state - sequence not defined {:-(");
-	  x->validJumpState = 0;
+	  x->nestSize[slot] = 0;
+	  return(-1);
+	}
+      for(; x->nestSize[slot] < size; x->nestSize[slot]++) x->nest[slot][x->nestSize[slot]].used = 0;
+    }
+  x->nest[slot][i].used = 1;
+  x->nest[slot][i].group = -1;
+  x->nest[slot][i].child = x->nest[slot][i].next = -1;
+  x->nest[slot][i].at = x->nest[slot][i].span = 0;
+  return(i);
+}
+
+static t_int nestCount(t_polyMath_tilde *x, t_int slot, t_int i)
+{
+  t_nestNode *nd = x->nest[slot];
+  t_int count = nd[i].n;
+  t_int c;
+  for(c = nd[i].child; c >= 0; c = nd[c].next) count += nestCount(x, slot, c) - nd[c].span;
+  return(count);
+}
+
+static t_int nestEmit(t_polyMath_tilde *x, t_int slot, t_int i, t_float size, t_int k)
+{
+  t_nestNode *nd = x->nest[slot];
+  t_float step = size / (t_float)nd[i].n;
+  t_int c = nd[i].child;
+  t_int s = 0;
+  while(s < nd[i].n)
+    {
+      if(c >= 0 && nd[c].at == s)
+	{
+	  k = nestEmit(x, slot, c, step * (t_float)nd[c].span, k);
+	  s += nd[c].span;
+	  c = nd[c].next;
 	}
       else
 	{
-	  post("Jumping to slot %d",x->nextSlot);
-	  x->validJumpState = 1;
-	  x->varPerf = 0;
-	  x->varTest = 0;        ;
+	  x->nestEvents[k++] = step;
+	  s++;
 	}
     }
-  if(argc > 0 && x->validJumpState)
+  return(k);
+}
+
+// write group g of the slot from its tree: only its own events are written, the rest are moved
+static void nestCompile(t_polyMath_tilde *x, t_int slot, t_int g, t_int r)
+{
+  t_int so = slot * MAXSEQ;
+  t_int e = x->grp.gStart[slot * GROUPS + g];
+  t_int old = grpEvents(x, slot, g);
+  t_int len = x->seq.len[slot];
+  t_int count = nestEmit(x, slot, r, atom_getfloatarg(slot * GROUPS + g, x->GROUPSIZE, x->grp.size), 0);
+  t_int f, k;
+  t_float size;
+  t_atom *a;
+  if(count != old)
     {
-      x->thisInVal = x->InVal;
-      if(x->scrambling)
+      for(f = 0; f < EVENTLIST; f++)
 	{
-	  x->JlastLen = x->var.len[x->lastSlot + x->lastVar * SLOTS];
-	  x->JlastCycle = (t_float)x->vGrp.cycles[x->lastSlot + x->lastVar * SLOTS];
+	  a = eventField(x, 0, f) + so;
+	  memmove(a + e + count, a + e + old, (len - e - old) * sizeof(t_atom));
+	  for(k = e + old; k < e + count; k++) SETFLOAT(&a[k], 0);
 	}
-      else
+      x->seq.len[slot] = len - old + count;
+      if(x->genSlot == slot) x->genSlot = -1;
+    }
+  // the accent lanes of the group stay with the event positions
+  for(k = 0; k < count; k++)
+    {
+      size = x->nestEvents[k];
+      SETFLOAT(&x->seq.eSize[so + e + k], size);
+      SETFLOAT(&x->seq.eSizeInv[so + e + k], 1 / size);
+      SETFLOAT(&x->seq.denom[so + e + k], 1 / size);
+      SETFLOAT(&x->seq.groupStep[so + e + k], (t_float)k);
+      SETFLOAT(&x->seq.eJoin[so + e + k], 1);
+      SETFLOAT(&x->seq.jSize[so + e + k], size);
+    }
+  SETFLOAT(&x->grp.n[slot * GROUPS + g], (t_float)count);
+  if(count != old) undoClearSlot(x, slot);
+  groupMarkStale(x, slot, g, e);
+}
+
+static t_int nestArgs(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv, t_int step, t_int *slot, t_int *g)
+{
+  if(argc < 2 || (argc - 2) % step != 0)
+    {
+      if(step == 3) post("nest: slot group at span n [at span n ...]");
+      else post("unnest: slot group [at span ...]");
+      return(0);
+    }
+  *slot = (t_int)atom_getfloat(argv);
+  *g = (t_int)atom_getfloat(argv + 1);
+  if(*slot < 0 || *slot >= SLOTS)
+    {
+      post("%s: slot is out of range: %d", s->s_name, *slot);
+      return(0);
+    }
+  if(*g < 0 || *g >= x->grp.nGroups[*slot] - fillerGroup(x, *slot))
+    {
+      post("%s: slot %d has %d groups, index %d is out of range", s->s_name, *slot, x->grp.nGroups[*slot] - fillerGroup(x, *slot), *g);
+      return(0);
+    }
+  // gStart of the group and of the next one are read by nestCompile
+  if(x->grpFixGroup[*slot] >= 0 && *g + 1 >= x->grpFixGroup[*slot]) groupFixSlot(x, *slot);
+  return(1);
+}
+
+void polyMath_tilde_nest(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  t_int slot, g, r, cur, c, prev, at, span, n, k, i, well;
+  t_nestNode *saved = 0;
+  t_int savedSize;
+  if(argc < 5 || !nestArgs(x, s, argc, argv, 3, &slot, &g)) return;
+  // kept until the edit is known to fit, so that a rejected path leaves the tree as it was
+  savedSize = x->nestSize[slot];
+  if(savedSize)
+    {
+      saved = (t_nestNode *)getbytes(savedSize * sizeof(t_nestNode));
+      if(saved == 0) return;
+      memcpy(saved, x->nest[slot], savedSize * sizeof(t_nestNode));
+    }
+  well = 1;
+  r = nestRoot(x, slot, g);
+  if(r < 0 && (r = nestAlloc(x, slot)) >= 0)
+    {
+      x->nest[slot][r].group = g;
+      x->nest[slot][r].n = grpEvents(x, slot, g);
+    }
+  if(r < 0) well = 0;
+  cur = r;
+  for(k = 2; k < argc && well; k += 3)
+    {
+      at = (t_int)atom_getfloat(argv + k);
+      span = (t_int)atom_getfloat(argv + k + 1);
+      n = (t_int)atom_getfloat(argv + k + 2);
+      if(at < 0 || span < 1 || n < 1 || at + span > x->nest[slot][cur].n)
 	{
-	  x->JlastLen = x->seq.len[x->lastSlot];
-	  x->JlastCycle = (t_float)x->grp.cycles[x->lastSlot];
+	  post("nest: steps %d - %d are not in a node of %d steps (or n < 1)", at, at + span - 1, x->nest[slot][cur].n);
+	  well = 0;
+	  break;
 	}
-      if(x->nextVar == 0)
+      prev = -1;
+      for(c = x->nest[slot][cur].child; c >= 0 && x->nest[slot][c].at + x->nest[slot][c].span <= at; c = x->nest[slot][c].next) prev = c;
+      if(c >= 0 && x->nest[slot][c].at == at && x->nest[slot][c].span == span)
 	{
-	  x->JnextLen = x->seq.len[x->nextSlot];
-	  x->JnextCycle = (t_float)x->grp.cycles[x->nextSlot];
+	  if(x->nest[slot][c].n != n)
+	    {
+	      for(i = x->nest[slot][c].child; i >= 0; i = x->nest[slot][i].next) nestDrop(x, slot, i);
+	      x->nest[slot][c].child = -1;
+	      x->nest[slot][c].n = n;
+	    }
+	  cur = c;
+	}
+      else if(c >= 0 && x->nest[slot][c].at < at + span)
+	{
+	  post("nest: steps %d - %d overlap a nested group at %d - %d", at, at + span - 1, x->nest[slot][c].at, x->nest[slot][c].at + x->nest[slot][c].span - 1);
+	  well = 0;
 	}
+      else if((i = nestAlloc(x, slot)) < 0) well = 0;
       else
 	{
-	  x->JnextLen = x->var.len[x->nextSlot + x->varPerf * SLOTS];
-	  x->JnextCycle = (t_float)x->vGrp.cycles[x->nextSlot + x->nextVar * SLOTS];
+	  x->nest[slot][i].at = at;
+	  x->nest[slot][i].span = span;
+	  x->nest[slot][i].n = n;
+	  x->nest[slot][i].next = c;
+	  if(prev >= 0) x->nest[slot][prev].next = i;
+	  else x->nest[slot][cur].child = i;
+	  cur = i;
 	}
-      x->JlocateFlag = 1;
-      if(!x->scrambling)
+    }
+  if(well && x->seq.len[slot] - grpEvents(x, slot, g) + nestCount(x, slot, r) > MAXSEQ)
+    {
+      post("nest: slot %d would be longer than %d events", slot, MAXSEQ);
+      well = 0;
+    }
+  if(!well)
+    {
+      if(x->nestSize[slot]) freebytes(x->nest[slot], x->nestSize[slot] * sizeof(t_nestNode));
+      x->nest[slot] = saved;
+      x->nestSize[slot] = savedSize;
+      return;
+    }
+  if(savedSize) freebytes(saved, savedSize * sizeof(t_nestNode));
+  nestCompile(x, slot, g, r);
+}
+
+void polyMath_tilde_unnest(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  t_int slot, g, r, cur, c, prev, at, span, k;
+  if(!nestArgs(x, s, argc, argv, 2, &slot, &g)) return;
+  if((r = nestRoot(x, slot, g)) < 0)
+    {
+      post("unnest: group %d of slot %d is not nested", g, slot);
+      return;
+    }
+  cur = r;
+  prev = -1;
+  for(k = 2; k < argc; k += 2)
+    {
+      at = (t_int)atom_getfloat(argv + k);
+      span = (t_int)atom_getfloat(argv + k + 1);
+      prev = -1;
+      for(c = x->nest[slot][cur].child; c >= 0 && !(x->nest[slot][c].at == at && x->nest[slot][c].span == span); c = x->nest[slot][c].next) prev = c;
+      if(c < 0)
 	{
-	  if(x->PStep == x->seq.len[x->lastSlot] - 1)
-	    {
-	      if(x->nextVar > 0)
-		{
-		  x->zeroNextSlot = 0;
-		  x->zeroNextVar = 1;
-		  x->JlocateFlag = 0;
-		  if(x->myBug == 10) post("!x->scrambling && zeroNextVar");
-		}
-	      else
-		{
-		  x->zeroNextSlot = 1;
-		  x->zeroNextVar = 0;
-		  x->JlocateFlag = 0;
-		  if(x->myBug == 10) post("!x->scrambling && zeroNextSlot");
-		}
-	    }
+	  post("unnest: no nested group at steps %d - %d", at, at + span - 1);
+	  return;
 	}
+      if(k + 2 < argc) cur = c;
       else
 	{
-	  if(x->PStep == x->var.len[x->lastSlot + x->lastVar * SLOTS] - 1)
-	    {
-	      if(x->nextVar > 0)
-		{
-		  x->zeroNextSlot = 0;
-		  x->zeroNextVar = 1;
-		  x->JlocateFlag = 0;
-		  if(x->myBug == 10) post("x->scrambling && zeroNextVar");
-		}
-	      else
-		{
-		  x->zeroNextSlot = 1;
-		  x->zeroNextVar = 0;
-		  x->JlocateFlag = 0;
-		  if(x->myBug == 10) post("x->scrambling && zeroNextSlot");
-		}
-	    }
+	  if(prev >= 0) x->nest[slot][prev].next = x->nest[slot][c].next;
+	  else x->nest[slot][cur].child = x->nest[slot][c].next;
+	  nestDrop(x, slot, c);
 	}
-      if(x->JlocateFlag)
+    }
+  if(argc == 2)
+    {
+      for(c = x->nest[slot][r].child; c >= 0; c = x->nest[slot][c].next) nestDrop(x, slot, c);
+      x->nest[slot][r].child = -1;
+    }
+  nestCompile(x, slot, g, r);
+  if(x->nest[slot][r].child < 0) x->nest[slot][r].used = 0;
+}
+
+void polyMath_tilde_setP(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  if(argc == 5) // Pslot, step, (p1/2/3/4/5/6/7/8), pNum, pVal
+    {
+      undoLane(x, argv, 3);
+      x->PSlot = (t_int)atom_getfloat(argv);
+      x->Pac = (t_int)atom_getfloat(argv+2);
+      switch(x->Pac)
 	{
-	  if(x->myBug == 10) post("Locating transition point");
-	  if(x->JlastCycle > x->JnextCycle)
-	    {
-	      if(x->nextVar > 0)
-		{
-		  if(x->JnextLen > 0)
-		    {
-		      x->Woff = 0;
-		      for(x->s = 0; x->Woff < x->JlastCycle; x->s++)
-			{
-			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.eSize);
-			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.varOff);
-			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
-			  x->Woff += x->JsizeNext;
-			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
-			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
-			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
-			}
-		    }
-		  else post("can't do - x->JnextLen = %d",x->JnextLen);
-		}
-	      else
-		{
-		  if(x->JnextLen > 0)
-		    {
-		      x->Woff = 0;
-		      for(x->s = 0; x->Woff < x->JlastCycle; x->s++)
-			{
-			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eSize);
-			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eOff);
-			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
-			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
-			  x->Woff += x->JsizeNext;
-			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
-			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
-			}
-		    }
-		  else post("can't do - x->JnextLen = %d",x->JnextLen);		  
-		}
-	    }
-  /* If the lastCycle > nextCycle and x->InVal > nextCycle, then the value of x->seq.wrapCycles2[n] will need to be subtracted
-   * from x->PGcyc when the transition is made to the next slot / var.
-   * A new function should be added to scramble - another value for the input list indicating to scramble e.g 0.5 of the sequence
-   * or to scramble the sequence 3 times, etc.
-   */
-	  else
-	    {
-	      if(x->nextVar > 0)
-		{
-		  if(x->JnextLen > 0)
-		    {
-		      x->Woff = 0;
-		      for(x->s = 0; x->Woff < x->JnextCycle; x->s++)
-			{
-			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.eSize);
-			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.varOff);
-			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
-			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
-			  x->Woff += x->JsizeNext;
-			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
-			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
-			}
-		    }
-		  else post("Can't do! x->JnextLen = %d",x->JnextLen);
-		}
-	      else
-		{
-		  if(x->JnextLen > 0)
-		    {
-		      x->Woff = 0;
-		      for(x->s = 0; x->Woff < x->JnextCycle; x->s++)
-			{
-			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eSize);
-			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eOff);
-			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
-			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
-			  x->Woff += x->JsizeNext;
-			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
-			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
-			}
-		    }
-		  else post("can't do - x->JnextLen = %d",x->JnextLen);
-		}
-	    }
-	  if(x->JnextLen > 0)
+	case(1):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  if(x->myBug > 0)
 	    {
-	      x->wrapLen = x->s + 1;
-	      x->JnextFlag = 0;
-	      for(x->s = 0; x->s < x->wrapLen; x->s++)
-		{
-		  if(!x->JnextFlag)
-		    {
-		      x->JoffNext = atom_getfloatarg(x->s,MAXSEQ,x->seq.wrapCycles1);
-		      x->JwrapCycle = atom_getfloatarg(x->s,MAXSEQ,x->seq.wrapCycles2);
-		      if(x->myBug == 10) post("x->JoffNext + x->JwrapCycle = %f, thisInVal + PGcyc = %f",x->JoffNext + x->JwrapCycle, x->thisInVal + x->PGcyc);
-		      if(x->JoffNext + x->JwrapCycle > x->thisInVal + x->PGcyc)
-			{
-			  x->nextShotVal = x->JoffNext + x->JwrapCycle;
-			  x->wrapSubVal = x->JwrapCycle;
-			  x->NStep = x->s;
-			  if(x->nextVar > 0)
-			    {
-			      x->changeSlot = 0;
-			      x->changeVar = 1;
-			    }
-			  else
-			    {
-			      x->changeSlot = 1;
-			      x->changeVar = 0;
-			    }
-			  x->JnextFlag = 1;
-			}
-		    }
-		}
+	      post("x->Location = %d, PLStep = %d, PSlot = %d", x->PLStep + x->PSlot * MAXSEQ, x->PLStep, x->PSlot);
+	      post("x->PSlot = %d", x->PSlot);
 	    }
-	  else post("Terminating procedure when length = %d",x->JnextLen);
+	  SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(2):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(3):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(4):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(5):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(6):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(7):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(8):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	default:
+	  break;
+	}
+      if(x->Pac > 0 && x->Pac < 9)
+	{
+	  markDirty(x, x->PSlot, 0, 9 + x->Pac * 2, x->PLStep, x->PLStep);
+	  markDirty(x, x->PSlot, 0, 10 + x->Pac * 2, x->PLStep, x->PLStep);
 	}
     }
-}
-
-/* ALL SCRAMBLE CODE GOES HERE */
-
-void polyMath_tilde_variation(t_polyMath_tilde *x, t_floatarg f) // OBSOLETE when starting from !0 - use _jumpTo instead
-{
-  //THIS WILL NEED TO BE REVISITED after the completion of the re-factoring of polyMath_tilde_nextSlot in the perf function!
-  x->varTest = f < 0 ? 0 : f > 8 ? 8 : (t_int)f;
-  if(x->varTest > 0)
+  else
     {
-      x->lastVar = x->varPerf;
-      x->varPerf = x->varTest - 1;
-      if(x->var.len[x->slot + x->varPerf * SLOTS] > 0) x->scrambling = 1;
+      post("pSet takes a 5 element list: [slotNum, stepNum, p1/2/3/4/5/6/7/8, pNum, pVal");
     }
 }
 
-t_int copySeq(t_polyMath_tilde *x, t_int slot, t_int varOffset)
+void polyMath_tilde_setPOnly(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
-  x->copyWell = 1;
-  for(x->o = 0; x->o < x->seq.len[slot]; x->o++)
+  if(txQueue(x, s, argc, argv)) return;
+  if(argc == 4) // Pslot, step, (p1/2/3/4), pNum
     {
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.allStep);
-      SETFLOAT(&x->var.varStep[varOffset + x->o],x->copyVal);
-      SETFLOAT(&x->var.allStep[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.groupStep);
-      SETFLOAT(&x->var.groupStep[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.groupNum);
-      SETFLOAT(&x->var.groupNum[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eSize);
-      if(x->myBug == 8) post("x->copyVal = %f",x->copyVal);
-      SETFLOAT(&x->var.eSize[varOffset + x->o],x->copyVal);
-      if(x->myBug == 15)
+      undoLane(x, argv, 1);
+      x->PSlot = (t_int)atom_getfloat(argv);
+      x->Pac = (t_int)atom_getfloat(argv+2);
+      switch(x->Pac)
 	{
-	  post("CHECK COPY VALUES:");
-	  post("varOffset = %d",varOffset);
-	  post("eSize = %f",x->copyVal);
-	  //  for(x->o = 0; x->o < x->seq.len[slot]; x->o++)
-	  //x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
-	  post("scramSlot = %d, thisVar = %d",(varOffset - (x->thisVar * x->SEQSIZE)) / MAXSEQ, (varOffset - (x->scramSlot * MAXSEQ)) / x->SEQSIZE);
-	  post("x->o = %d",x->o);
+	case(1):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(2):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  if(x->myBug > 0)
+	    {
+	      post("x->Location = %d",x->PLStep + x->PSlot * MAXSEQ);
+	      post("x->PSlot = %d",x->PSlot);
+	    }
+	  SETFLOAT(&x->seq.pAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(3):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(4):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(5):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(6):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(7):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	case(8):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  SETFLOAT(&x->seq.pAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  //SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+4));
+	  break;
+	default:
+	  break;
 	}
-      if(atom_getfloatarg(varOffset + x->o, x->VARSIZE, x->var.eSize) == 0)
+      if(x->Pac > 0 && x->Pac < 9) markDirty(x, x->PSlot, 0, 9 + x->Pac * 2, x->PLStep, x->PLStep);
+    }
+  else
+    {
+      post("pSetOnly takes a 4 element list: [slotNum, stepNum, p1/2/3/4/5/6/7/8, pNum");
+    }
+}
+
+void polyMath_tilde_setVOnly(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(txQueue(x, s, argc, argv)) return;
+  if(argc == 4) // Pslot, step, (p1/2/3/4), vNum
+    {
+      undoLane(x, argv, 2);
+      x->PSlot = (t_int)atom_getfloat(argv);
+      x->Pac = (t_int)atom_getfloat(argv+2);
+      switch(x->Pac)
 	{
-	  post("Event size must be greater than 0 :-( copyVal = %f",x->copyVal);
-	  x->copyWell = 0;
+	case(1):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(2):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  if(x->myBug > 0)
+	    {
+	      post("x->Location = %d",x->PLStep + x->PSlot * MAXSEQ);
+	      post("x->PSlot = %d",x->PSlot);
+	    }
+	  //SETFLOAT(&x->seq.pAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc2[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(3):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc3[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(4):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc4[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(5):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc5[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(6):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc6[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(7):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc7[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	case(8):
+	  x->PLStep = (t_int)atom_getfloat(argv+1);
+	  x->PLStep = x->PLStep >= MAXSEQ ? MAXSEQ - 1 : x->PLStep < 0 ? 0 : x->PLStep;
+	  //SETFLOAT(&x->seq.pAcc1[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  SETFLOAT(&x->seq.eAcc8[x->PLStep + x->PSlot * MAXSEQ],atom_getfloat(argv+3));
+	  break;
+	default:
+	  break;
 	}
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eOff);
-      SETFLOAT(&x->var.eOff[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eJoin);
-      SETFLOAT(&x->var.eJoin[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.jSize);
-      SETFLOAT(&x->var.jSize[varOffset + x->o],x->copyVal);
-      if(atom_getfloatarg(varOffset + x->o, x->VARSIZE, x->var.jSize) == 0)
+      if(x->Pac > 0 && x->Pac < 9) markDirty(x, x->PSlot, 0, 10 + x->Pac * 2, x->PLStep, x->PLStep);
+    }
+  else
+    {
+      post("vSetOnly takes a 4 element list: [slotNum, stepNum, p1/2/3/4/5/6/7/8, pVal");
+    }
+}
+
+/* RANGE WRITES
+ * pSetRange slot var lane start end stride p e: p and e to every stride-th step from start to end (inclusive)
+ * pSetLane slot var lane p e p e ...: the whole lane from step 0, one p e pair per step
+ * pSetLane slot var lane parray earray: the whole lane from two tables, one value per step
+ * var 0 is the sequence of the slot, 1 - VARIATIONS a variation. Steps stop at the length of the sequence.
+ */
+// checks slot, var and lane, and finds the base of the sequence and its two accent columns: 0 = bad arguments
+static t_int laneColumns(t_polyMath_tilde *x, const char *name, t_int slot, t_int var, t_int lane, t_int *base, t_int *len, t_atom **pAcc, t_atom **eAcc)
+{
+  if(slot < 0 || slot >= SLOTS || var < 0 || var > VARIATIONS || lane < 1 || lane > 8)
+    {
+      post("%s: slot 0 - %d, var 0 - %d, lane 1 - 8", name, SLOTS - 1, VARIATIONS);
+      return(0);
+    }
+  *base = var > 0 ? slot * MAXSEQ + (var - 1) * x->SEQSIZE : slot * MAXSEQ;
+  *len = var > 0 ? x->var.len[slot + (var - 1) * SLOTS] : x->seq.len[slot];
+  *pAcc = eventField(x, var > 0, 15 + lane) + *base;
+  *eAcc = eventField(x, var > 0, 7 + lane) + *base;
+  if(*len < 1)
+    {
+      post("%s: the sequence is empty", name);
+      return(0);
+    }
+  return(1);
+}
+
+void polyMath_tilde_pSetRange(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, var, lane, start, end, stride, base, len, k;
+  t_float p, e;
+  t_atom *pAcc, *eAcc;
+  if(txQueue(x, s, argc, argv)) return;
+  if(argc != 8)
+    {
+      post("pSetRange takes an 8 element list: [slotNum, var, p1/2/3/4/5/6/7/8, start, end, stride, pNum, pVal]");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  var = (t_int)atom_getfloat(argv + 1);
+  lane = (t_int)atom_getfloat(argv + 2);
+  if(!laneColumns(x, "pSetRange", slot, var, lane, &base, &len, &pAcc, &eAcc)) return;
+  start = (t_int)atom_getfloat(argv + 3);
+  end = (t_int)atom_getfloat(argv + 4);
+  stride = (t_int)atom_getfloat(argv + 5);
+  p = atom_getfloat(argv + 6);
+  e = atom_getfloat(argv + 7);
+  start = start < 0 ? 0 : start;
+  end = end >= len ? len - 1 : end;
+  stride = stride < 1 ? 1 : stride;
+  if(start > end) return;
+  undoSave(x, undoNext(x), slot, var, start, end - start + 1, 0, (1 << (15 + lane)) | (1 << (7 + lane)));
+  for(k = start; k <= end; k += stride)
+    {
+      SETFLOAT(&pAcc[k], p);
+      SETFLOAT(&eAcc[k], e);
+    }
+  markDirty(x, slot, var, 9 + lane * 2, start, end);
+  markDirty(x, slot, var, 10 + lane * 2, start, end);
+}
+
+void polyMath_tilde_pSetLane(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, var, lane, base, len, n, k, pSize, eSize;
+  t_atom *pAcc, *eAcc;
+  t_garray *pArray, *eArray;
+  t_word *pVec, *eVec;
+  int size;
+  if(txQueue(x, s, argc, argv)) return;
+  if(argc < 5)
+    {
+      post("pSetLane: [slotNum, var, p1/2/3/4/5/6/7/8, pNum pVal pNum pVal ...] or [slotNum, var, p1-8, parray, earray]");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  var = (t_int)atom_getfloat(argv + 1);
+  lane = (t_int)atom_getfloat(argv + 2);
+  if(!laneColumns(x, "pSetLane", slot, var, lane, &base, &len, &pAcc, &eAcc)) return;
+  if(argv[3].a_type == A_SYMBOL)
+    {
+      if(argc != 5 || argv[4].a_type != A_SYMBOL)
 	{
-	  post("Join size must be greater than 0 :-(");
-	  x->copyWell = 0;
+	  post("pSetLane: give two tables, parray and earray");
+	  return;
+	}
+      pArray = (t_garray *)pd_findbyclass(atom_getsymbol(argv + 3), garray_class);
+      eArray = (t_garray *)pd_findbyclass(atom_getsymbol(argv + 4), garray_class);
+      if(!pArray || !garray_getfloatwords(pArray, &size, &pVec))
+	{
+	  post("pSetLane: %s: no such table", atom_getsymbol(argv + 3)->s_name);
+	  return;
+	}
+      pSize = size;
+      if(!eArray || !garray_getfloatwords(eArray, &size, &eVec))
+	{
+	  post("pSetLane: %s: no such table", atom_getsymbol(argv + 4)->s_name);
+	  return;
+	}
+      eSize = size;
+      n = pSize < eSize ? pSize : eSize;
+      n = n < len ? n : len;
+      undoSave(x, undoNext(x), slot, var, 0, n, 0, (1 << (15 + lane)) | (1 << (7 + lane)));
+      for(k = 0; k < n; k++)
+	{
+	  SETFLOAT(&pAcc[k], pVec[k].w_float);
+	  SETFLOAT(&eAcc[k], eVec[k].w_float);
+	}
+    }
+  else
+    {
+      if((argc - 3) % 2 == 1)
+	{
+	  post("pSetLane: each step needs pNum and pVal");
+	  return;
+	}
+      n = (argc - 3) / 2;
+      n = n < len ? n : len;
+      undoSave(x, undoNext(x), slot, var, 0, n, 0, (1 << (15 + lane)) | (1 << (7 + lane)));
+      for(k = 0; k < n; k++)
+	{
+	  SETFLOAT(&pAcc[k], atom_getfloat(argv + 3 + k * 2));
+	  SETFLOAT(&eAcc[k], atom_getfloat(argv + 4 + k * 2));
+	}
+    }
+  if(n < 1) return;
+  markDirty(x, slot, var, 9 + lane * 2, 0, n - 1);
+  markDirty(x, slot, var, 10 + lane * 2, 0, n - 1);
+}
+
+/* data types:
+ * dType --- data
+ * 99    --- {slot, variation}
+ * 98    --- {slot, length}
+ */
+
+void polyMath_tilde_slot(t_polyMath_tilde *x, t_floatarg f)
+{
+  x->slot = f < 0 ? 0 : f >= SLOTS ? SLOTS - 1 : (t_int)f;
+  //SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
+  //x->outList[0] = (t_float)x->slot;
+  //x->outList[1] = (t_float)x->variation;
+  SETFLOAT(&x->outList[0], (t_float)x->slot);
+  SETFLOAT(&x->outList[1], (t_float)x->variation);
+  outlet_float(x->dType, 99);
+  outlet_list(x->dataOut, gensym("list"), 2, x->outList);
+}
+
+void polyMath_tilde_slotLen(t_polyMath_tilde *x, t_floatarg f)
+{
+  x->getSlotLen = f < 0 ? 0 : f >= SLOTS ? SLOTS - 1 : (t_int)f;
+  //t_int isLength, t_int getSlot;
+  x->isLength = x->seq.len[x->getSlotLen];
+  SETFLOAT(&x->outList[0], (t_float)x->getSlotLen);
+  SETFLOAT(&x->outList[1], (t_float)x->isLength);
+  outlet_float(x->dType, 98);
+  outlet_list(x->dataOut, gensym("list"), 2, x->outList);  
+}
+
+//useless: lastLen
+/* VARIATION POOL */
+static void freePoolVar(t_poolVar *v)
+{
+  if(v->len > 0)
+    {
+      freebytes(v->data, BUILDFIELDS * v->len * sizeof(t_float));
+      freebytes(v->gStart, v->nGroups * sizeof(t_int));
+      freebytes(v->grp, 5 * v->nGroups * sizeof(t_float));
+    }
+  v->len = v->nGroups = 0;
+}
+
+static t_int allocPoolVar(t_poolVar *v, t_int len, t_int nGroups)
+{
+  freePoolVar(v);
+  v->data = (t_float *)getbytes(BUILDFIELDS * len * sizeof(t_float));
+  v->gStart = (t_int *)getbytes(nGroups * sizeof(t_int));
+  v->grp = (t_float *)getbytes(5 * nGroups * sizeof(t_float));
+  if(!v->data || !v->gStart || !v->grp)
+    {
+      if(v->data) freebytes(v->data, BUILDFIELDS * len * sizeof(t_float));
+      if(v->gStart) freebytes(v->gStart, nGroups * sizeof(t_int));
+      if(v->grp) freebytes(v->grp, 5 * nGroups * sizeof(t_float));
+      return(0);
+    }
+  v->len = len;
+  v->nGroups = nGroups;
+  return(1);
+}
+
+// var (1-based) -> pool entry, or 0 if var is not a filled pool entry of this slot
+static t_poolVar *poolVar(t_polyMath_tilde *x, t_int slot, t_int var)
+{
+  t_int k = var - VARIATIONS - 1;
+  if(slot < 0 || slot >= SLOTS || k < 0 || k >= x->poolSize[slot]) return(0);
+  return(&x->pool[slot][k]);
+}
+
+// fixed variation (1-based) -> pool
+static t_int storeFromVar(t_polyMath_tilde *x, t_int slot, t_int var, t_poolVar *v)
+{
+  t_int f, i, g;
+  t_int vIdx = slot + (var - 1) * SLOTS;
+  t_int varOffset = slot * MAXSEQ + (var - 1) * x->SEQSIZE;
+  t_int grpOffset = slot * GROUPS + (var - 1) * x->GROUPSIZE;
+  t_int len = x->var.len[vIdx];
+  t_int nGroups = x->vGrp.nGroups[vIdx];
+  if(len < 1 || nGroups < 1 || !allocPoolVar(v, len, nGroups)) return(0);
+  v->cycles = x->vGrp.cycles[vIdx];
+  for(f = 0; f < BUILDFIELDS; f++)
+    for(i = 0; i < len; i++) v->data[f * len + i] = atom_getfloatarg(varOffset + i, x->VARSIZE, buildField(x, 1, f));
+  for(g = 0; g < nGroups; g++)
+    {
+      v->gStart[g] = x->vGrp.gStart[grpOffset + g];
+      v->grp[g] = atom_getfloatarg(grpOffset + g, x->VGROUPSIZE, x->vGrp.n);
+      v->grp[nGroups + g] = atom_getfloatarg(grpOffset + g, x->VGROUPSIZE, x->vGrp.d);
+      v->grp[nGroups * 2 + g] = atom_getfloatarg(grpOffset + g, x->VGROUPSIZE, x->vGrp.offset);
+      v->grp[nGroups * 3 + g] = atom_getfloatarg(grpOffset + g, x->VGROUPSIZE, x->vGrp.size);
+      v->grp[nGroups * 4 + g] = atom_getfloatarg(grpOffset + g, x->VGROUPSIZE, x->vGrp.sizeInv);
+    }
+  return(1);
+}
+
+// finished background scramble -> pool
+static t_int storeFromBuild(t_varBuild *b, t_poolVar *v)
+{
+  t_int f, i, g;
+  if(!allocPoolVar(v, b->len, b->nGroups)) return(0);
+  v->cycles = b->cycles;
+  for(f = 0; f < BUILDFIELDS; f++)
+    for(i = 0; i < b->len; i++) v->data[f * b->len + i] = atom_getfloatarg(f * MAXSEQ + i, BUILDFIELDS * MAXSEQ, b->dst);
+  for(g = 0; g < b->nGroups; g++)
+    {
+      v->gStart[g] = b->gStart[g];
+      v->grp[g] = atom_getfloatarg(g, GROUPS, b->n);
+      v->grp[b->nGroups + g] = atom_getfloatarg(g, GROUPS, b->d);
+      v->grp[b->nGroups * 2 + g] = atom_getfloatarg(g, GROUPS, b->offset);
+      v->grp[b->nGroups * 3 + g] = atom_getfloatarg(g, GROUPS, b->size);
+      v->grp[b->nGroups * 4 + g] = atom_getfloatarg(g, GROUPS, b->sizeInv);
+    }
+  return(1);
+}
+
+// a staging variation may be written if it is empty or holds an unedited pool copy, and is not playing
+static t_int poolStageFree(t_polyMath_tilde *x, t_int slot, t_int stage)
+{
+  if(x->scrambling && x->slot == slot && x->varPerf == stage - 1) return(0);
+  return(x->var.variations[slot + (stage - 1) * SLOTS] == 0 || (x->poolStaged[slot] >> (stage - VARIATIONS + 1) & 1));
+}
+
+/* copy a pool entry into a staging variation so that perform can play it - returns the staging
+ * variation (1-based) or 0. The pool is staged through the last two fixed variations (VARIATIONS-1 and
+ * VARIATIONS), taken in turn; a slot that plays its pool has to leave one of them free. A variation that
+ * holds its own sequence (a scramble, a store or an edit since it was staged) is never overwritten.
+ */
+static t_int stagePoolVar(t_polyMath_tilde *x, t_int slot, t_int var)
+{
+  t_poolVar *v = poolVar(x, slot, var);
+  t_int f, i, g, stage, vIdx, varOffset, grpOffset;
+  if(v == 0 || v->len < 1)
+    {
+      post("variation %d of slot %d is not in the pool", var, slot);
+      return(0);
+    }
+  stage = VARIATIONS - 1 + x->poolStage[slot];
+  if(!poolStageFree(x, slot, stage)) stage = stage == VARIATIONS ? VARIATIONS - 1 : VARIATIONS;
+  if(!poolStageFree(x, slot, stage))
+    {
+      post("variation %d of slot %d: variations %d and %d are in use, free one of them to play the pool", var, slot, VARIATIONS - 1, VARIATIONS);
+      return(0);
+    }
+  x->poolStage[slot] = stage == VARIATIONS ? 0 : 1;
+  undoSave(x, undoNext(x), slot, stage, 0, 0, 1, UNDO_ALL);
+  vIdx = slot + (stage - 1) * SLOTS;
+  varOffset = slot * MAXSEQ + (stage - 1) * x->SEQSIZE;
+  grpOffset = slot * GROUPS + (stage - 1) * x->GROUPSIZE;
+  for(f = 0; f < BUILDFIELDS; f++)
+    for(i = 0; i < v->len; i++) SETFLOAT(buildField(x, 1, f) + varOffset + i, v->data[f * v->len + i]);
+  for(g = 0; g < v->nGroups; g++)
+    {
+      x->vGrp.gStart[grpOffset + g] = v->gStart[g];
+      SETFLOAT(&x->vGrp.n[grpOffset + g], v->grp[g]);
+      SETFLOAT(&x->vGrp.d[grpOffset + g], v->grp[v->nGroups + g]);
+      SETFLOAT(&x->vGrp.offset[grpOffset + g], v->grp[v->nGroups * 2 + g]);
+      SETFLOAT(&x->vGrp.size[grpOffset + g], v->grp[v->nGroups * 3 + g]);
+      SETFLOAT(&x->vGrp.sizeInv[grpOffset + g], v->grp[v->nGroups * 4 + g]);
+    }
+  x->vGrp.nGroups[vIdx] = v->nGroups;
+  x->vGrp.cycles[vIdx] = v->cycles;
+  x->var.len[vIdx] = v->len;
+  x->var.variations[vIdx] = 1;
+  markDirty(x, slot, stage, -1, 0, v->len - 1);
+  x->poolStaged[slot] |= 1 << (stage - VARIATIONS + 1);
+  return(stage);
+}
+
+// varPool slot size: pool entries are variations VARIATIONS+1 ... VARIATIONS+size of the slot
+void polyMath_tilde_varPool(t_polyMath_tilde *x, t_floatarg fSlot, t_floatarg fSize)
+{
+  t_int slot = (t_int)fSlot;
+  t_int size = (t_int)fSize;
+  t_int k;
+  if(slot < 0 || slot >= SLOTS || size < 0)
+    {
+      post("varPool takes a slot (0 - %d) and a pool size", SLOTS - 1);
+      return;
+    }
+  for(k = size; k < x->poolSize[slot]; k++) freePoolVar(&x->pool[slot][k]);
+  if(size == 0)
+    {
+      if(x->poolSize[slot]) freebytes(x->pool[slot], x->poolSize[slot] * sizeof(t_poolVar));
+      x->pool[slot] = 0;
+    }
+  else if(x->poolSize[slot] == 0) x->pool[slot] = (t_poolVar *)getbytes(size * sizeof(t_poolVar));
+  else x->pool[slot] = (t_poolVar *)resizebytes(x->pool[slot], x->poolSize[slot] * sizeof(t_poolVar), size * sizeof(t_poolVar));
+  for(k = x->poolSize[slot]; k < size; k++) x->pool[slot][k].len = x->pool[slot][k].nGroups = 0;
+  x->poolSize[slot] = x->pool[slot] ? size : 0;
+}
+
+// storeVar slot fromVar toVar: copy a fixed variation (1 - VARIATIONS) into the pool
+void polyMath_tilde_storeVar(t_polyMath_tilde *x, t_floatarg fSlot, t_floatarg fFrom, t_floatarg fTo)
+{
+  t_int slot = (t_int)fSlot;
+  t_int from = (t_int)fFrom;
+  t_poolVar *v = poolVar(x, slot, (t_int)fTo);
+  if(from < 1 || from > VARIATIONS || v == 0) post("storeVar takes a slot, a variation (1 - %d) and a pool variation (%d - %d)", VARIATIONS, VARIATIONS + 1, VARIATIONS + (slot >= 0 && slot < SLOTS ? x->poolSize[slot] : 0));
+  else if(!storeFromVar(x, slot, from, v)) post("storeVar: variation %d of slot %d is empty", from, slot);
+}
+
+// freeVar slot var: empty a pool entry, or a fixed variation
+void polyMath_tilde_freeVar(t_polyMath_tilde *x, t_floatarg fSlot, t_floatarg fVar)
+{
+  t_int slot = (t_int)fSlot;
+  t_int var = (t_int)fVar;
+  t_poolVar *v = poolVar(x, slot, var);
+  if(v) freePoolVar(v);
+  else if(slot >= 0 && slot < SLOTS && var > 0 && var <= VARIATIONS)
+    {
+      if(x->scrambling && x->slot == slot && x->varPerf == var - 1) post("freeVar: variation %d of slot %d is playing", var, slot);
+      else
+	{
+	  x->var.variations[slot + (var - 1) * SLOTS] = 0;
+	  x->var.len[slot + (var - 1) * SLOTS] = 0;
+	}
+    }
+  else post("freeVar: no variation %d in slot %d", var, slot);
+}
+
+// morph slot var amount (0 - 1, 0 = off)
+void polyMath_tilde_morph(t_polyMath_tilde *x, t_floatarg fSlot, t_floatarg fVar, t_floatarg fAmount)
+{
+  t_int slot = (t_int)fSlot;
+  t_int var = (t_int)fVar;
+  if(slot < 0 || slot >= SLOTS || var < 1 || var > VARIATIONS)
+    {
+      post("morph takes a slot, a variation (1 - %d) and an amount (0 - 1)", VARIATIONS);
+      return;
+    }
+  if(fAmount > 0 && x->var.variations[slot + (var - 1) * SLOTS] == 0)
+    {
+      post("morph: slot %d has no variation %d", slot, var);
+      return;
+    }
+  x->morphSlot = slot;
+  x->morphVar = var;
+  x->morphAmt = fAmount < 0 ? 0 : fAmount > 1 ? 1 : fAmount;
+  x->morphOn = 0;
+  polyMath_tilde_morphMask(x);
+}
+
+void polyMath_tilde_jumpNext(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  //t_int lastOffset, nextOffset;
+  x->validJumpState = 0;
+  //lastOffset = x->slot * MAXSEQ; nextOffset = x->slot * MAXSEQ; // just initialize in case no args presented
+  if(argc == 2)
+    {
+      x->lastVar = x->varPerf;
+      x->lastSlot = x->slot;
+      x->nextSlot = (t_int)atom_getfloat(argv);
+      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot; 
+      x->nextVar = (t_int)atom_getfloat(argv+1);
+      if(x->nextVar > VARIATIONS && !(x->nextVar = stagePoolVar(x, x->nextSlot, x->nextVar))) return;
+      x->nextVar = x->nextVar < 0 ? 0 : x->nextVar >= VARIATIONS ? VARIATIONS : x->nextVar;
+      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
+      else x->JlastOffset = x->lastSlot * MAXSEQ;
+      if(x->nextVar > 0)
+	{
+	  x->JnextOffset = x->nextSlot * MAXSEQ + x->varPerf * x->SEQSIZE;
+	  if(x->myBug == 10) post("x->JnextOffset = %d, x->nextSlot = %d, x->varPerf = %d",x->JnextOffset,x->nextSlot,x->varPerf);
+	}
+      else x->JnextOffset = x->nextSlot * MAXSEQ;
+      if(x->nextVar == 0)
+	{
+	  if(x->seq.len[x->nextSlot] == 0)
+	    {
+	      post("Invalid jump state - sequence not defined {:-(");
+	      x->validJumpState = 0;
+	    }
+	  else
+	    {
+	      post("Jumping to slot %d",x->nextSlot);
+	      x->validJumpState = 1;
+	    }
+	}
+      else
+	{
+	  if(x->var.variations[x->nextSlot + (x->nextVar - 1) * SLOTS] == 0)
+	    {
+	      post("Invalid jump state - variation not defined [;-(");
+	      x->validJumpState = 0;
+	    }
+	  else
+	    {
+	      post("Jumping to variation %d of slot %d",x->nextVar,x->nextSlot);
+	      x->validJumpState = 1;
+	    }
+	}    
+    }
+  else if(argc == 1)
+    {
+      x->nextVar = 0;
+      x->lastVar = x->varPerf;
+      x->lastSlot = x->slot;
+      x->nextSlot = (t_int)atom_getfloat(argv);
+      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot;
+      if(x->myBug == 10) post("nextSlot = %d",x->nextSlot);
+      x->nextVar = 0;
+      //x->varPerf = 0;
+      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
+      else x->JlastOffset = x->lastSlot * MAXSEQ;
+      x->JnextOffset = x->nextSlot * MAXSEQ;
+      if(x->seq.len[x->nextSlot] == 0)
+	{
+	  post("Invalid jump state - sequence not defined {:-(");
+	  x->validJumpState = 0;
+	}
+      else
+	{
+	  post("Jumping to slot %d",x->nextSlot);
+	  x->validJumpState = 1;
+	  x->varPerf = 0;
+	}
+    }
+  if(x->validJumpState)
+    {
+      x->varTest = x->nextVar;
+      x->zeroNextSlot = 0;
+      x->zeroNextVar = 0;
+      x->changeSlot = 0;
+      x->changeVar = 0;
+      if(x->nextVar == 0)
+	{
+	  x->jumpSlotAtEnd = 1;	
+	  x->jumpVarAtEnd = 0;
+	}
+      else
+	{
+	  x->jumpVarAtEnd = 1;
+	  x->jumpSlotAtEnd = 0;
 	}
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eSizeInv);
-      SETFLOAT(&x->var.eSizeInv[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc1);
-      SETFLOAT(&x->var.eAcc1[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc1);
-      SETFLOAT(&x->var.pAcc1[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc2);
-      SETFLOAT(&x->var.eAcc2[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc2);
-      SETFLOAT(&x->var.pAcc2[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc3);
-      SETFLOAT(&x->var.eAcc3[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc3);
-      SETFLOAT(&x->var.pAcc3[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc4);
-      SETFLOAT(&x->var.eAcc4[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc4);
-      SETFLOAT(&x->var.pAcc4[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc5);
-      SETFLOAT(&x->var.eAcc5[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc5);
-      SETFLOAT(&x->var.pAcc5[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc6);
-      SETFLOAT(&x->var.eAcc6[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc6);
-      SETFLOAT(&x->var.pAcc6[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc7);
-      SETFLOAT(&x->var.eAcc7[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc7);
-      SETFLOAT(&x->var.pAcc7[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc8);
-      SETFLOAT(&x->var.eAcc8[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc8);
-      SETFLOAT(&x->var.pAcc8[varOffset + x->o],x->copyVal);
-      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.denom);
-      SETFLOAT(&x->var.denom[varOffset + x->o],x->copyVal);
-      //if(x->myBug == 9) post("varOffset + x->o = %d",varOffset + x->o);//post("d = %f", x->copyVal);
     }
-  return(x->copyWell);
 }
 
-t_int scrambleSeq(t_polyMath_tilde *x, t_int varOffset, t_int slot)
+void polyMath_tilde_jumpTo(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv) // Jan 17th 2018
 {
-  x->scramWell = 1;
-  for(x->q = 0; x->q < x->doSwaps; x->q++) 
+  //t_int lastOffset, nextOffset;
+  //t_int lastLen, nextLen, iWrap, nextFlag, locateFlag;
+  //t_float lastCycle, nextCycle;
+  //t_float sizeLast, offLast,
+  //  sizeNext, offNext, wrapCycle;
+  x->validJumpState = 0;
+  //lastOffset = x->slot * MAXSEQ; x->JnextOffset = x->slot * MAXSEQ; // just initialize in case no args presented
+  if(argc == 2)
     {
-      //t_int scrambleSeq(t_polyMath_tilde *x, t_int slot, t_int varOffset, t_int var, t_int len, t_float prob)
-      //here is where we rewrite VARIATION SEQUENCES
-      x->swapVal1 = x->vGrp.swapsRef[x->q];
-      x->swapVal2 = x->vGrp.swapsRef[x->q + MAXSEQ];
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.allStep);
-      SETFLOAT(&x->var.varStep[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.groupStep);
-      SETFLOAT(&x->var.groupStep[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.groupNum);
-      SETFLOAT(&x->var.groupNum[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eSize);
-      if(x->myBug == 15)
-	{
-	  post("CHECK VALUES:");
-	  post("varOffset = %d",varOffset);
-	  post("eSize = %f",x->swapVal);
-	  //x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
-	  post("scramSlot = %d, thisVar = %d",(varOffset - (x->thisVar * x->SEQSIZE)) / MAXSEQ, (varOffset - (x->scramSlot * MAXSEQ)) / x->SEQSIZE);
-	  post("x->q = %d",x->q);
+      x->lastVar = x->varPerf;
+      x->lastSlot = x->slot;
+      x->nextSlot = (t_int)atom_getfloat(argv);
+      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot; 
+      x->nextVar = (t_int)atom_getfloat(argv+1);
+      if(x->nextVar > VARIATIONS && !(x->nextVar = stagePoolVar(x, x->nextSlot, x->nextVar))) return;
+      x->nextVar = x->nextVar < 0 ? 0 : x->nextVar > VARIATIONS ? VARIATIONS : x->nextVar;
+      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
+      else x->JlastOffset = x->lastSlot * MAXSEQ;
+      if(x->nextVar > 0)
+	{//should this be x->varPerf or x->nextVar?
+	  x->varPerf = x->nextVar - 1;
+	  x->varTest = x->nextVar;
+	  x->JnextOffset = x->nextSlot * MAXSEQ + x->varPerf * x->SEQSIZE;
+	  //x->JnextOffset = x->nextSlot * MAXSEQ + (x->nextVar - 1) * x->SEQSIZE;
+	  if(x->myBug == 10) post("x->JnextOffset = %d, x->nextSlot = %d, x->varPerf = %d", x->JnextOffset, x->nextSlot, x->varPerf);
 	}
-      SETFLOAT(&x->var.eSize[varOffset + x->swapVal2],x->swapVal);
-      if(atom_getfloatarg(varOffset + x->swapVal1, x->VARSIZE, x->var.eSize) == 0)
+      else x->JnextOffset = x->nextSlot * MAXSEQ;
+      if(x->nextVar == 0)
 	{
-	  post("Event size must be greater than 0 '-(");
-	  x->scramWell = 0;
+	  if(x->seq.len[x->nextSlot] == 0)
+	    {
+	      post("Invalid jump state - sequence not defined {:-(");
+	      x->validJumpState = 0;
+	    }
+	  else
+	    {
+	      post("Jumping to slot %d",x->nextSlot);
+	      x->varTest = x->nextVar;
+	      x->validJumpState = 1;
+	    }
 	}
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eOff);
-      SETFLOAT(&x->var.eOff[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eJoin);
-      SETFLOAT(&x->var.eJoin[varOffset + x->swapVal2],x->swapVal);
-      if(x->swapVal > 1)
+      else
 	{
-          for(x->r = 0; x->r < (t_int)x->swapVal; x->r++)
+	  //x->var.variations[x->slot + x->thisVar * SLOTS] = 1;
+	  if(x->myBug == 9)
+	    {
+	      post("x->var.variations: %d", x->var.variations[x->slot + (x->nextVar - 1) * SLOTS]);
+	      post("x->var.variations: %d", x->var.variations[x->slot + x->nextVar * SLOTS]);
+	      //post("x->var.variations: %d", x->var.variations[x->slot + (x->nextVar + 1) * SLOTS]);
+
+	    }
+	  if(x->var.variations[x->nextSlot + (x->nextVar - 1) * SLOTS] == 0)
+	    {
+	      post("Invalid jump state - variation not defined [;-(");
+	      x->validJumpState = 0;
+	    }
+	  else
 	    {
-	      SETFLOAT(&x->var.eJoin[varOffset + x->swapVal1 + x->r],1);
-	      //excludes?
-	      if(x->r > 0) SETFLOAT(&x->var.eJoin[varOffset + x->swapVal2 + x->r],1);
+	      x->varPerf = x->nextVar > 0 ? x->nextVar - 1 : 0;
+	      post("Jumping to variation %d of slot %d",x->nextVar,x->nextSlot);
+	      x->validJumpState = 1;
+	      x->varTest = x->nextVar;
 	    }
+	}    
+    }
+  else if(argc == 1)
+    {
+      x->nextVar = 0;
+      x->lastVar = x->varPerf;
+      x->lastSlot = x->slot;
+      x->nextSlot = (t_int)atom_getfloat(argv);
+      x->nextSlot = x->nextSlot < 0 ? 0 : x->nextSlot >= SLOTS ? SLOTS - 1 : x->nextSlot;
+      if(x->myBug == 10) post("nextSlot = %d",x->nextSlot);
+      x->nextVar = 0;
+      //x->varPerf = 0;
+      if(x->scrambling == 1) x->JlastOffset = x->lastSlot * MAXSEQ + x->lastVar * x->SEQSIZE;
+      else x->JlastOffset = x->lastSlot * MAXSEQ;
+      x->JnextOffset = x->nextSlot * MAXSEQ;
+      if(x->seq.len[x->nextSlot] == 0)
+	{
+	  post("Invalid jump state - sequence not defined {:-(");
+	  x->validJumpState = 0;
+	}
+      else
+	{
+	  post("Jumping to slot %d",x->nextSlot);
+	  x->validJumpState = 1;
+	  x->varPerf = 0;
+	  x->varTest = 0;        ;
 	}
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.jSize);
-      SETFLOAT(&x->var.jSize[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eSizeInv);
-      SETFLOAT(&x->var.eSizeInv[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc1);
-      SETFLOAT(&x->var.eAcc1[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc1);
-      SETFLOAT(&x->var.pAcc1[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc2);
-      SETFLOAT(&x->var.eAcc2[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc2);
-      SETFLOAT(&x->var.pAcc2[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc3);
-      SETFLOAT(&x->var.eAcc3[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc3);
-      SETFLOAT(&x->var.pAcc3[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc4);
-      SETFLOAT(&x->var.eAcc4[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc4);
-      SETFLOAT(&x->var.pAcc4[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc5);
-      SETFLOAT(&x->var.eAcc5[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc5);
-      SETFLOAT(&x->var.pAcc5[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc6);
-      SETFLOAT(&x->var.eAcc6[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc6);
-      SETFLOAT(&x->var.pAcc6[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc7);
-      SETFLOAT(&x->var.eAcc7[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc7);
-      SETFLOAT(&x->var.pAcc7[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc8);
-      SETFLOAT(&x->var.eAcc8[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc8);
-      SETFLOAT(&x->var.pAcc8[varOffset + x->swapVal2],x->swapVal);
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.denom);
-      SETFLOAT(&x->var.denom[varOffset + x->swapVal2],x->swapVal);
-      if(x->swapVal == 0) x->scramWell = 0;
-      if(x->myBug == 8) post("denom = %d",(t_int)x->swapVal);
     }
-  return(x->scramWell);
-}
-
-t_int copySeqElements(t_polyMath_tilde *x, t_int slot, t_int var, t_int destVar, t_int groupOffset, t_int newGroupOffset, t_int length)
-{
-  x->copyWell = 1;
-  t_int loc, destLoc;
-  for(x->r = 0; x->r < length; x->r++)
+  if(argc > 0 && x->validJumpState)
     {
-      if(var == 0)
+      x->thisInVal = x->InVal;
+      if(x->scrambling)
 	{
-	  loc = slot * MAXSEQ + groupOffset + x->r;
-	  destLoc = slot * MAXSEQ + destVar * x->SEQSIZE + newGroupOffset + x->r;
+	  x->JlastLen = x->var.len[x->lastSlot + x->lastVar * SLOTS];
+	  x->JlastCycle = (t_float)x->vGrp.cycles[x->lastSlot + x->lastVar * SLOTS];
 	}
       else
 	{
-	//slot * MAXSEQ + varSeq * x->SEQSIZE + location
-	  loc = slot * MAXSEQ + var * x->VARSIZE + x->r;
-	  destLoc = slot * MAXSEQ + destVar * x->VARSIZE + newGroupOffset + x->r;
-	}
-      if(var == 0)
-	{
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.allStep);
-	  SETFLOAT(&x->var.varStep[destLoc],x->copyVal);
-	  SETFLOAT(&x->var.allStep[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.groupStep);
-	  SETFLOAT(&x->var.groupStep[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.groupNum);
-	  SETFLOAT(&x->var.groupNum[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eSize);
-	  //if(x->myBug == 8) post("x->copyVal = %f",x->copyVal);
-	  SETFLOAT(&x->var.eSize[destLoc],x->copyVal);
-	  /*if(x->myBug == 15)
-	    {
-	      post("CHECK COPY VALUES:");
-	      post("varOffset = %d",varOffset);
-	      post("eSize = %f",x->copyVal);
-	      //  for(x->o = 0; x->o < x->seq.len[slot]; x->o++)
-	      //x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
-	      post("scramSlot = %d, thisVar = %d",(varOffset - (x->thisVar * x->SEQSIZE)) / MAXSEQ, (varOffset - (x->scramSlot * MAXSEQ)) / x->SEQSIZE);
-	      post("x->o = %d",x->o);
-	      }
-      if(atom_getfloatarg(destLoc, x->VARSIZE, x->var.eSize) == 0)
+	  x->JlastLen = x->seq.len[x->lastSlot];
+	  x->JlastCycle = (t_float)x->grp.cycles[x->lastSlot];
+	}
+      if(x->nextVar == 0)
 	{
-	  post("Event size must be greater than 0 :-( copyVal = %f",x->copyVal);
-	  x->copyWell = 0;
-	}*/
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eOff);
-	  SETFLOAT(&x->var.eOff[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eJoin);
-	  SETFLOAT(&x->var.eJoin[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.jSize);
-	  SETFLOAT(&x->var.jSize[destLoc],x->copyVal);
-	  /*if(atom_getfloatarg(destLoc, x->VARSIZE, x->var.jSize) == 0)
-	    {
-	      post("Join size must be greater than 0 :-(");
-	      x->copyWell = 0;
-	      }*/
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eSizeInv);
-	  SETFLOAT(&x->var.eSizeInv[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc1);
-	  SETFLOAT(&x->var.eAcc1[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc1);
-	  SETFLOAT(&x->var.pAcc1[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc2);
-	  SETFLOAT(&x->var.eAcc2[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc2);
-	  SETFLOAT(&x->var.pAcc2[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc3);
-	  SETFLOAT(&x->var.eAcc3[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc3);
-	  SETFLOAT(&x->var.pAcc3[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc4);
-	  SETFLOAT(&x->var.eAcc4[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc4);
-	  SETFLOAT(&x->var.pAcc4[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc5);
-	  SETFLOAT(&x->var.eAcc5[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc5);
-	  SETFLOAT(&x->var.pAcc5[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc6);
-	  SETFLOAT(&x->var.eAcc6[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc6);
-	  SETFLOAT(&x->var.pAcc6[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc7);
-	  SETFLOAT(&x->var.eAcc7[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc7);
-	  SETFLOAT(&x->var.pAcc7[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.eAcc8);
-	  SETFLOAT(&x->var.eAcc8[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.pAcc8);
-	  SETFLOAT(&x->var.pAcc8[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->SEQSIZE, x->seq.denom);
-	  SETFLOAT(&x->var.denom[destLoc],x->copyVal);
-      x->GSPlace++;
-	}
-      else if(var > 0) //error check this in the _group Scramble function
-	{
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.allStep);
-	  SETFLOAT(&x->var.varStep[destLoc],x->copyVal);
-	  SETFLOAT(&x->var.allStep[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.groupStep);
-	  SETFLOAT(&x->var.groupStep[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.groupNum);
-	  SETFLOAT(&x->var.groupNum[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eSize);
-	  if(x->myBug == 8) post("x->copyVal = %f",x->copyVal);
-	  SETFLOAT(&x->var.eSize[destLoc],x->copyVal);
-	  /*if(x->myBug == 15)
-	    {
-	      post("CHECK COPY VALUES:");
-	      post("varOffset = %d",varOffset);
-	      post("eSize = %f",x->copyVal);
-	      //  for(x->o = 0; x->o < x->seq.len[slot]; x->o++)
-	      //x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
-	      post("scramSlot = %d, thisVar = %d",(varOffset - (x->thisVar * x->SEQSIZE)) / MAXSEQ, (varOffset - (x->scramSlot * MAXSEQ)) / x->SEQSIZE);
-	      post("x->o = %d",x->o);
-	      }
-      if(atom_getfloatarg(destLoc, x->VARSIZE, x->var.eSize) == 0)
+	  x->JnextLen = x->seq.len[x->nextSlot];
+	  x->JnextCycle = (t_float)x->grp.cycles[x->nextSlot];
+	}
+      else
 	{
-	  post("Event size must be greater than 0 :-( copyVal = %f",x->copyVal);
-	  x->copyWell = 0;
-	}*/
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eOff);
-	  SETFLOAT(&x->var.eOff[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eJoin);
-	  SETFLOAT(&x->var.eJoin[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.jSize);
-	  SETFLOAT(&x->var.jSize[destLoc],x->copyVal);
-	  /*if(atom_getfloatarg(destLoc, x->VARSIZE, x->var.jSize) == 0)
+	  x->JnextLen = x->var.len[x->nextSlot + x->varPerf * SLOTS];
+	  x->JnextCycle = (t_float)x->vGrp.cycles[x->nextSlot + x->nextVar * SLOTS];
+	}
+      x->JlocateFlag = 1;
+      if(!x->scrambling)
+	{
+	  if(x->PStep == x->seq.len[x->lastSlot] - 1)
 	    {
-	      post("Join size must be greater than 0 :-(");
-	      x->copyWell = 0;
-	      }*/
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eSizeInv);
-	  SETFLOAT(&x->var.eSizeInv[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc1);
-	  SETFLOAT(&x->var.eAcc1[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc1);
-	  SETFLOAT(&x->var.pAcc1[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc2);
-	  SETFLOAT(&x->var.eAcc2[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc2);
-	  SETFLOAT(&x->var.pAcc2[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc3);
-	  SETFLOAT(&x->var.eAcc3[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc3);
-	  SETFLOAT(&x->var.pAcc3[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc4);
-	  SETFLOAT(&x->var.eAcc4[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc4);
-	  SETFLOAT(&x->var.pAcc4[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc5);
-	  SETFLOAT(&x->var.eAcc5[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc5);
-	  SETFLOAT(&x->var.pAcc5[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc6);
-	  SETFLOAT(&x->var.eAcc6[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc6);
-	  SETFLOAT(&x->var.pAcc6[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc7);
-	  SETFLOAT(&x->var.eAcc7[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc7);
-	  SETFLOAT(&x->var.pAcc7[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.eAcc8);
-	  SETFLOAT(&x->var.eAcc8[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.pAcc8);
-	  SETFLOAT(&x->var.pAcc8[destLoc],x->copyVal);
-	  x->copyVal = atom_getfloatarg(loc, x->VARSIZE, x->var.denom);
-	  SETFLOAT(&x->var.denom[destLoc],x->copyVal);
-	  x->GSPlace++;
+	      if(x->nextVar > 0)
+		{
+		  x->zeroNextSlot = 0;
+		  x->zeroNextVar = 1;
+		  x->JlocateFlag = 0;
+		  if(x->myBug == 10) post("!x->scrambling && zeroNextVar");
+		}
+	      else
+		{
+		  x->zeroNextSlot = 1;
+		  x->zeroNextVar = 0;
+		  x->JlocateFlag = 0;
+		  if(x->myBug == 10) post("!x->scrambling && zeroNextSlot");
+		}
+	    }
 	}
-      //if(x->myBug == 9) post("varOffset + x->o = %d",varOffset + x->o);//post("d = %f", x->copyVal);
-    }
-  return(x->copyWell);
-}
-
-void polyMath_tilde_groupScramble(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
-// COULD PROBABLY USE REGROUP INSTEAD!!!
-{
-  t_int nGroups, index, numEvents;
-  //args: slot, var, destVar, scramRand, (mode CHANGED BEHAVIOUR)
-  //if mode == 0, just do that percentage of scrambles
-  //if mode == 1, ensure exactly that number of unique displacements is carried out (NOT IMPLEMENTED)
-  //if mode == 2, scramble all of them, ensuring that none end up in the same place (order) as before
-  //defaults:
-  x->GSScramRand = 0.5;
-
-  if(argc == 4)
-    {
-      x->GSSlot = (t_int)atom_getfloat(argv+0);
-      x->GSVar = (t_int)atom_getfloat(argv+1);
-      x->GSDestVar = (t_int)atom_getfloat(argv+2);
-      x->GSScramRand = atom_getfloat(argv+3);
-      x->GSMode = 0;
-    }
-  else if(argc == 3)
-    {
-      x->GSSlot = (t_int)atom_getfloat(argv+0);
-      x->GSVar = (t_int)atom_getfloat(argv+1);
-      x->GSDestVar = (t_int)atom_getfloat(argv+2);
-      //x->GSScramRand = atom_getfloat(argv+3);
-      x->GSMode = 2;
-    }
-  if(argc == 4 || argc == 3)
-    {
-      if(x->GSSlot >= SLOTS || x->GSSlot < 0) post("slot must be a whole number from 0 to %d",SLOTS - 1);
-      else if(x->GSVar < 0 || x->GSVar > VARIATIONS) post("var must bo 0 (no-var) or a whole number from 1 to %d",VARIATIONS);
-      else if(x->GSDestVar < 0 || x->GSDestVar > VARIATIONS) post("dest var must bo 0 (no-var) or a whole number from 1 to %d",VARIATIONS);
-      else if(x->GSScramRand < 0 || x->GSScramRand > 1) post("randomness must be a floating point number from 0 to 1");
-      else if(x->GSVar == x->GSDestVar) post("destination variation must not be the same as source variation");
-      // later on mybe we could make a "scramble-in-place"
       else
 	{
-	  if(x->GSMode == 0)
+	  if(x->PStep == x->var.len[x->lastSlot + x->lastVar * SLOTS] - 1)
+	    {
+	      if(x->nextVar > 0)
+		{
+		  x->zeroNextSlot = 0;
+		  x->zeroNextVar = 1;
+		  x->JlocateFlag = 0;
+		  if(x->myBug == 10) post("x->scrambling && zeroNextVar");
+		}
+	      else
+		{
+		  x->zeroNextSlot = 1;
+		  x->zeroNextVar = 0;
+		  x->JlocateFlag = 0;
+		  if(x->myBug == 10) post("x->scrambling && zeroNextSlot");
+		}
+	    }
+	}
+      if(x->JlocateFlag)
+	{
+	  if(x->myBug == 10) post("Locating transition point");
+	  if(x->JlastCycle > x->JnextCycle)
 	    {
-	      /*x->randNum1 = drand48();
-		x->fSwapsNum = x->fSeqLen * prob;
-		x->swapsNum = rounder(x,x->fSwapsNum,x->seqLen - 1);	    x->doSwaps = x->swapsNum;*/
-	      if(x->GSVar == 0)
+	      if(x->nextVar > 0)
+		{
+		  if(x->JnextLen > 0)
+		    {
+		      x->Woff = 0;
+		      for(x->s = 0; x->Woff < x->JlastCycle; x->s++)
+			{
+			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.eSize);
+			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.varOff);
+			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
+			  x->Woff += x->JsizeNext;
+			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
+			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
+			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
+			}
+		    }
+		  else post("can't do - x->JnextLen = %d",x->JnextLen);
+		}
+	      else
 		{
-		  
+		  if(x->JnextLen > 0)
+		    {
+		      x->Woff = 0;
+		      for(x->s = 0; x->Woff < x->JlastCycle; x->s++)
+			{
+			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eSize);
+			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eOff);
+			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
+			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
+			  x->Woff += x->JsizeNext;
+			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
+			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
+			}
+		    }
+		  else post("can't do - x->JnextLen = %d",x->JnextLen);		  
 		}
-	      post("groupScramble Mode 0: NOT YET IMPLEMENTED!");
-	    }
-	  else if(x->GSMode == 1)
-	    {
-	      post("groupScramble Mode 1: NOT YET IMPLEMENTED!");
 	    }
-	  else if(x->GSMode == 2)
+  /* If the lastCycle > nextCycle and x->InVal > nextCycle, then the value of x->seq.wrapCycles2[n] will need to be subtracted
+   * from x->PGcyc when the transition is made to the next slot / var.
+   * A new function should be added to scramble - another value for the input list indicating to scramble e.g 0.5 of the sequence
+   * or to scramble the sequence 3 times, etc.
+   */
+	  else
 	    {
-	      if(x->GSVar > 0) x->swapsNum = nGroups = x->vGrp.nGroups[x->GSSlot + x->GSVar * SLOTS];
-	      else x->swapsNum = nGroups = x->grp.nGroups[x->GSSlot];
-	      x->fSwapsNum = (t_float)x->swapsNum;
-	      for(x->o = 0; x->o < x->swapsNum; x->o++)
-		{
-		  x->vGrp.groupSwaps[x->o] = -1;
-		}
-	      while(nGroups)
+	      if(x->nextVar > 0)
 		{
-		  x->o = 0;
-		  x->randNum1 = drand48();
-		  x->randNum2 = drand48();
-		  x->GSFSwap = x->randNum1 * x->fSwapsNum;
-		  x->GSISwap = (t_int)x->GSFSwap;
-		  if(x->o != x->GSISwap)
+		  if(x->JnextLen > 0)
 		    {
-		      x->vGrp.groupSwaps[x->GSISwap] = x->o;
-		      x->o++;
-		      nGroups--;
+		      x->Woff = 0;
+		      for(x->s = 0; x->Woff < x->JnextCycle; x->s++)
+			{
+			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.eSize);
+			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->VARSIZE, x->var.varOff);
+			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
+			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
+			  x->Woff += x->JsizeNext;
+			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
+			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
+			}
 		    }
-		  else if(x->swapsNum == 1 && x->o == x->GSISwap)
+		  else post("Can't do! x->JnextLen = %d",x->JnextLen);
+		}
+	      else
+		{
+		  if(x->JnextLen > 0)
 		    {
-		      //kludge? recursion? ignore? ignore!
-		      x->vGrp.groupSwaps[x->GSISwap] = x->o;
-		      //x->o++;
-		      nGroups--;		  
+		      x->Woff = 0;
+		      for(x->s = 0; x->Woff < x->JnextCycle; x->s++)
+			{
+			  x->JsizeNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eSize);
+			  x->JoffNext = atom_getfloatarg(x->JnextOffset + (x->s % x->JnextLen), x->SEQSIZE, x->seq.eOff);
+			  if(x->myBug == 10) post("x->s = %d, x->JsizeNext = %f, x->JoffNext = %f",x->s,x->JsizeNext,x->JoffNext);
+			  x->JiWrap = (x->s / x->JnextLen) * (t_int)x->JnextCycle;
+			  x->Woff += x->JsizeNext;
+			  SETFLOAT(&x->seq.wrapCycles1[x->s],x->JoffNext);
+			  SETFLOAT(&x->seq.wrapCycles2[x->s],(t_float)x->JiWrap);
+			}
 		    }
-		  /*NEXT:
-		    write a function to rewrite the sequence according to the new group arrangement
-		    t_int gStart[GROUPS * SLOTS * VARIATIONS];        // where in the sequence does each group start?
-		    t_atom n[GROUPS * SLOTS * VARIATIONS];          // numerator of the time sig (fraction)
-		  */
+		  else post("can't do - x->JnextLen = %d",x->JnextLen);
 		}
-	      //  x->E_Acc6 = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.eAcc6);
-	      for(x->o = 0; x->o < x->swapsNum; x->o++)
+	    }
+	  if(x->JnextLen > 0)
+	    {
+	      x->wrapLen = x->s + 1;
+	      x->JnextFlag = 0;
+	      for(x->s = 0; x->s < x->wrapLen; x->s++)
 		{
-		  x->p = (t_int)x->vGrp.groupSwaps[x->o];
-		  {
-		    //numEvents: slot or var offset + grp offset
-		    if(x->GSVar > 0)
-		      {
-			if(x->GSVar != x->GSDestVar)
-			  {
-			    x->GSPlace = 0;
-			    nGroups = x->vGrp.nGroups[x->GSSlot * VARIATIONS + x->GSVar];
-			    x->scLen = (t_int)atom_getfloatarg(x->GSSlot * VARIATIONS + x->p, x->VGROUPSIZE, x->vGrp.n);
-			    x->scOff = (t_int)atom_getfloatarg(x->GSSlot * VARIATIONS + x->p, x->VGROUPSIZE, x->vGrp.offset);
-  //int copySeqElements(t_polyMath_tilde *x, int slot, int var, int destVar, int groupOffset, int newGroupOffset, int length)
-			    //where do we get newOffset from?
-			    if(x->myBug == 18)
-			      {
-				post("copyElements(x, %d, %d, %d, %d, %d, %d)",x->GSSlot, x->GSVar, x->GSDestVar, x->scOff, x->p, x->scLen);
-			      }
-			    copySeqElements(x, x->GSSlot, x->GSVar, x->GSDestVar, x->scOff, x->p, x->scLen);
-			    //for(x->q = 0; x->q < x->vGrp.d[x->GSSlot * VARIATIONS + x->p]; x->q++)
-			    //{
-			    //int copySeqElements(t_polyMath_tilde *x, int slot, int var, int destVar, int groupOffset, int newGroupOffset, int length)
-			    //   copySeqElements(x, x->GSSlot, x->GSVar, x->GSDestVar, offset, x->p, length);  // what about length?
-			    //}
-			  }
-			else
-			  {
-			    post("destination variation must be different from the source");
-			  }
-		      }									     
-		    else if(x->GSVar == 0)
-		      {
-			if(x->GSDestVar > 0 && x->GSDestVar <= VARIATIONS)
-			  {
-			    nGroups = x->grp.nGroups[x->GSSlot];
-			    x->scLen = (t_int)atom_getfloatarg(x->GSSlot * VARIATIONS + x->p, x->VGROUPSIZE, x->vGrp.n);
-			    x->scOff = (t_int)atom_getfloatarg(x->GSSlot * VARIATIONS + x->p, x->VGROUPSIZE, x->vGrp.offset);
-  //t_int copySeqElements(t_polyMath_tilde *x, t_int slot, t_int var, t_int destVar, t_int groupOffset, t_int newGroupOffset, t_int length)
-			    //where do we get newOffset from?
-			    if(x->myBug == 18)
-			      {
-				post("copyElements(x, %d, %d, %d, %d, %d, %d)",x->GSSlot, x->GSVar, x->GSDestVar, x->scOff, x->p, x->scLen);
-			      }
-			    copySeqElements(x, x->GSSlot, x->GSVar, x->GSDestVar, x->scOff, x->p, x->scLen);
-			  }
-			else
-			  {
-			    post("destination variation out-of-bounds");
-			  }
-		      }
-		  }		
+		  if(!x->JnextFlag)
+		    {
+		      x->JoffNext = atom_getfloatarg(x->s,MAXSEQ,x->seq.wrapCycles1);
+		      x->JwrapCycle = atom_getfloatarg(x->s,MAXSEQ,x->seq.wrapCycles2);
+		      if(x->myBug == 10) post("x->JoffNext + x->JwrapCycle = %f, thisInVal + PGcyc = %f",x->JoffNext + x->JwrapCycle, x->thisInVal + x->PGcyc);
+		      if(x->JoffNext + x->JwrapCycle > x->thisInVal + x->PGcyc)
+			{
+			  x->nextShotVal = x->JoffNext + x->JwrapCycle;
+			  x->wrapSubVal = x->JwrapCycle;
+			  x->NStep = x->s;
+			  if(x->nextVar > 0)
+			    {
+			      x->changeSlot = 0;
+			      x->changeVar = 1;
+			    }
+			  else
+			    {
+			      x->changeSlot = 1;
+			      x->changeVar = 0;
+			    }
+			  x->JnextFlag = 1;
+			}
+		    }
 		}
-	      //t_int scramSuccess = scramGroup(x, x->GSSlot, x->
 	    }
+	  else post("Terminating procedure when length = %d",x->JnextLen);
 	}
     }
-      //else post("Insufficient arguments to groupScramble!");  
 }
 
-t_int regroup(t_polyMath_tilde *x, t_int grpOffset, t_int varOffset, t_int slot, t_int var, t_int len)
+/* ALL SCRAMBLE CODE GOES HERE */
+
+void polyMath_tilde_variation(t_polyMath_tilde *x, t_floatarg f) // OBSOLETE when starting from !0 - use _jumpTo instead
 {
-  x->groupWell = 1;
-  x->VGnm = 0;
-  x->VGCount = 0;
-  x->VGSize = 0;
-  for(x->p = 0; x->p < len; x->p++)
+  //THIS WILL NEED TO BE REVISITED after the completion of the re-factoring of polyMath_tilde_nextSlot in the perf function!
+  x->varTest = f < 0 ? 0 : f > 8 ? 8 : (t_int)f;
+  if(x->varTest > 0)
     {
-      //here is where we rewrite GROUPS
-      //t_int VGnm, VGCount, VEJoin;
-      //t_float Vd, VESize, VGSize, VEOff, VGOff, VJSize, VJoin, VVStep, VVLast, VONext;
-      x->VESize = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.eSize);
-      //x->VJSize = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.jSize);
-      x->VVStep = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.varStep);
-      x->Vd = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.denom);
-      x->VEOff = atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.eOff);      
-      x->vGrp.cycles[slot + var * SLOTS] = x->grp.cycles[slot];
-      if(x->p == 0)
+      x->lastVar = x->varPerf;
+      x->varPerf = x->varTest - 1;
+      if(x->var.len[x->slot + x->varPerf * SLOTS] > 0) x->scrambling = 1;
+    }
+}
+
+t_int copySeq(t_polyMath_tilde *x, t_int slot, t_int varOffset)
+{
+  x->copyWell = 1;
+  for(x->o = 0; x->o < x->seq.len[slot]; x->o++)
+    {
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.allStep);
+      SETFLOAT(&x->var.varStep[varOffset + x->o],x->copyVal);
+      SETFLOAT(&x->var.allStep[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.groupStep);
+      SETFLOAT(&x->var.groupStep[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.groupNum);
+      SETFLOAT(&x->var.groupNum[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eSize);
+      if(x->myBug == 8) post("x->copyVal = %f",x->copyVal);
+      SETFLOAT(&x->var.eSize[varOffset + x->o],x->copyVal);
+      if(x->myBug == 15)
 	{
-	  x->VGSize += x->VESize;
-	  x->VGOff = x->VEOff;
-	  SETFLOAT(&x->vGrp.offset[grpOffset],x->VGOff);
-	  SETFLOAT(&x->vGrp.size[grpOffset],x->VGSize);
-	  if(x->VGSize <= 0) x->scramWell = 0;
-	  else
-	    {
-	      x->VGSizeInv = 1 / x->VGSize;
-	      SETFLOAT(&x->vGrp.sizeInv[grpOffset],x->VGSizeInv);
-	    }
-	  SETFLOAT(&x->vGrp.n[grpOffset],(t_float)x->VGCount + 1);
-	  SETFLOAT(&x->vGrp.d[grpOffset],x->Vd);
-	  x->vGrp.gStart[grpOffset] = (t_int)x->VVStep;
-	  x->vGrp.nGroups[slot + var * SLOTS] = 1; //x->VGnm + 1
-	  x->VONext = x->VEOff + x->VESize;
-	  SETFLOAT(&x->var.groupStep[varOffset],0);
-	  SETFLOAT(&x->var.groupNum[varOffset],0);
-	  x->VVLast = x->VVStep;
-	  x->VLastD = x->Vd;
+	  post("CHECK COPY VALUES:");
+	  post("varOffset = %d",varOffset);
+	  post("eSize = %f",x->copyVal);
+	  //  for(x->o = 0; x->o < x->seq.len[slot]; x->o++)
+	  //x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
+	  post("scramSlot = %d, thisVar = %d",(varOffset - (x->thisVar * x->SEQSIZE)) / MAXSEQ, (varOffset - (x->scramSlot * MAXSEQ)) / x->SEQSIZE);
+	  post("x->o = %d",x->o);
 	}
-      else
+      if(atom_getfloatarg(varOffset + x->o, x->VARSIZE, x->var.eSize) == 0)
 	{
-	  if(x->VEOff != x->VONext)
-	    {
-	      x->VGnm++;
-	      x->VGCount = 0;
-	      x->VGSize = x->VESize;
-	      if(x->VGSize == 0) x->scramWell = 0;
-	      else x->VGSizeInv = 1 / x->VGSize;
-	      x->VGOff = x->VEOff;
-	      SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
-	      SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
-	      x->vGrp.gStart[grpOffset + x->VGnm] = (t_int)x->VVStep;
-	      x->vGrp.nGroups[slot + var * SLOTS] = x->VGnm + 1;
-	    }
-	  else if(x->VVStep != x->VVLast + 1)
-	    {
-	      x->VGnm++;
-	      x->VGCount = 0;
-	      x->VGSize = x->VESize;
-	      if(x->VGSize == 0) x->scramWell = 0;
-	      else x->VGSizeInv = 1 / x->VGSize;
-	      x->VGOff = x->VEOff;
-	      SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
-	      SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
-	      x->vGrp.gStart[grpOffset + x->VGnm] = (t_int)x->VVStep;
-	      x->vGrp.nGroups[slot + var * SLOTS] = x->VGnm + 1;
-	    }
-	  else if(x->VLastD != x->Vd)
-	    {
-	      x->VGnm++;
-	      x->VGCount = 0;
-	      x->VGSize = x->VESize;
-	      if(x->VGSize == 0) x->scramWell = 0;
-	      else x->VGSizeInv = 1 / x->VGSize;
-	      x->VGOff = x->VEOff;
-	      SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
-	      SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
-	      x->vGrp.gStart[grpOffset + x->VGnm] = (t_int)x->VVStep;
-	      x->vGrp.nGroups[slot + var * SLOTS] = x->VGnm + 1;
-	    }
-	  else 
-	    {
-	      x->VGCount++;
-	      x->VGSize += x->VESize;
-	      if(x->VGSize == 0) x->scramWell = 0;
-	      else x->VGSizeInv = 1 / x->VGSize;
-	    }
-	  SETFLOAT(&x->vGrp.offset[grpOffset + x->VGnm],x->VGOff);
-	  SETFLOAT(&x->vGrp.size[grpOffset + x->VGnm],x->VGSize);
-	  SETFLOAT(&x->vGrp.sizeInv[grpOffset + x->VGnm],x->VGSizeInv);
-	  SETFLOAT(&x->vGrp.n[grpOffset + x->VGnm],(t_float)x->VGCount + 1);
-	  SETFLOAT(&x->vGrp.d[grpOffset + x->VGnm],x->Vd);
-	  x->VONext = x->VEOff + x->VESize;
-	  SETFLOAT(&x->var.groupStep[varOffset + x->p],(t_float)x->VGCount);
-	  SETFLOAT(&x->var.groupNum[varOffset + x->p],x->VGnm);
-	  x->VVLast = x->VVStep;
-	  x->VLastD = x->Vd;
+	  post("Event size must be greater than 0 :-( copyVal = %f",x->copyVal);
+	  x->copyWell = 0;
+	}
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eOff);
+      SETFLOAT(&x->var.eOff[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eJoin);
+      SETFLOAT(&x->var.eJoin[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.jSize);
+      SETFLOAT(&x->var.jSize[varOffset + x->o],x->copyVal);
+      if(atom_getfloatarg(varOffset + x->o, x->VARSIZE, x->var.jSize) == 0)
+	{
+	  post("Join size must be greater than 0 :-(");
+	  x->copyWell = 0;
 	}
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eSizeInv);
+      SETFLOAT(&x->var.eSizeInv[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc1);
+      SETFLOAT(&x->var.eAcc1[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc1);
+      SETFLOAT(&x->var.pAcc1[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc2);
+      SETFLOAT(&x->var.eAcc2[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc2);
+      SETFLOAT(&x->var.pAcc2[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc3);
+      SETFLOAT(&x->var.eAcc3[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc3);
+      SETFLOAT(&x->var.pAcc3[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc4);
+      SETFLOAT(&x->var.eAcc4[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc4);
+      SETFLOAT(&x->var.pAcc4[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc5);
+      SETFLOAT(&x->var.eAcc5[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc5);
+      SETFLOAT(&x->var.pAcc5[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc6);
+      SETFLOAT(&x->var.eAcc6[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc6);
+      SETFLOAT(&x->var.pAcc6[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc7);
+      SETFLOAT(&x->var.eAcc7[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc7);
+      SETFLOAT(&x->var.pAcc7[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.eAcc8);
+      SETFLOAT(&x->var.eAcc8[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.pAcc8);
+      SETFLOAT(&x->var.pAcc8[varOffset + x->o],x->copyVal);
+      x->copyVal = atom_getfloatarg(slot * MAXSEQ + x->o, x->SEQSIZE, x->seq.denom);
+      SETFLOAT(&x->var.denom[varOffset + x->o],x->copyVal);
+      //if(x->myBug == 9) post("varOffset + x->o = %d",varOffset + x->o);//post("d = %f", x->copyVal);
     }
-  return(x->groupWell);
+  return(x->copyWell);
 }
 
-t_int varOffsets(t_polyMath_tilde *x, t_int varOffset, t_int len)
+t_int scrambleSeq(t_polyMath_tilde *x, t_int varOffset, t_int slot)
 {
-  x->varWrite = 1;
-  x->varOff = 0;
-  x->swapVal = 0;
-  for(x->p = 0; x->p < len; x->p++)
+  x->scramWell = 1;
+  for(x->q = 0; x->q < x->doSwaps; x->q++) 
     {
-      SETFLOAT(&x->var.varOff[varOffset + x->p], x->varOff);
-      x->swapVal1 = (t_int)atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.groupStep);
-      if(x->swapVal1 == 0) x->swapVal = x->varOff;
-      SETFLOAT(&x->var.grpOff[varOffset + x->p], x->swapVal);
-      x->varOff += atom_getfloatarg(varOffset + x->p, x->VARSIZE, x->var.eSize);
-      if(x->myBug == 8) post("varOff = %f, grpOff = %f");
+      //t_int scrambleSeq(t_polyMath_tilde *x, t_int slot, t_int varOffset, t_int var, t_int len, t_float prob)
+      //here is where we rewrite VARIATION SEQUENCES
+      x->swapVal1 = x->vGrp.swapsRef[x->q];
+      x->swapVal2 = x->vGrp.swapsRef[x->q + MAXSEQ];
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.allStep);
+      SETFLOAT(&x->var.varStep[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.groupStep);
+      SETFLOAT(&x->var.groupStep[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.groupNum);
+      SETFLOAT(&x->var.groupNum[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eSize);
+      if(x->myBug == 15)
+	{
+	  post("CHECK VALUES:");
+	  post("varOffset = %d",varOffset);
+	  post("eSize = %f",x->swapVal);
+	  //x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
+	  post("scramSlot = %d, thisVar = %d",(varOffset - (x->thisVar * x->SEQSIZE)) / MAXSEQ, (varOffset - (x->scramSlot * MAXSEQ)) / x->SEQSIZE);
+	  post("x->q = %d",x->q);
+	}
+      SETFLOAT(&x->var.eSize[varOffset + x->swapVal2],x->swapVal);
+      if(atom_getfloatarg(varOffset + x->swapVal1, x->VARSIZE, x->var.eSize) == 0)
+	{
+	  post("Event size must be greater than 0 '-(");
+	  x->scramWell = 0;
+	}
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eOff);
+      SETFLOAT(&x->var.eOff[varOffset + x->swapVal2],x->swapVal);
+      // join runs move as whole blocks (see scrambleSwaps), so eJoin is copied like any other field
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eJoin);
+      SETFLOAT(&x->var.eJoin[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.jSize);
+      SETFLOAT(&x->var.jSize[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eSizeInv);
+      SETFLOAT(&x->var.eSizeInv[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc1);
+      SETFLOAT(&x->var.eAcc1[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc1);
+      SETFLOAT(&x->var.pAcc1[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc2);
+      SETFLOAT(&x->var.eAcc2[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc2);
+      SETFLOAT(&x->var.pAcc2[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc3);
+      SETFLOAT(&x->var.eAcc3[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc3);
+      SETFLOAT(&x->var.pAcc3[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc4);
+      SETFLOAT(&x->var.eAcc4[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc4);
+      SETFLOAT(&x->var.pAcc4[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc5);
+      SETFLOAT(&x->var.eAcc5[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc5);
+      SETFLOAT(&x->var.pAcc5[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc6);
+      SETFLOAT(&x->var.eAcc6[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc6);
+      SETFLOAT(&x->var.pAcc6[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc7);
+      SETFLOAT(&x->var.eAcc7[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc7);
+      SETFLOAT(&x->var.pAcc7[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.eAcc8);
+      SETFLOAT(&x->var.eAcc8[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.pAcc8);
+      SETFLOAT(&x->var.pAcc8[varOffset + x->swapVal2],x->swapVal);
+      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->swapVal1, x->SEQSIZE, x->seq.denom);
+      SETFLOAT(&x->var.denom[varOffset + x->swapVal2],x->swapVal);
+      if(x->swapVal == 0) x->scramWell = 0;
+      if(x->myBug == 8) post("denom = %d",(t_int)x->swapVal);
     }
-  return(x->varWrite);
+  return(x->scramWell);
 }
 
 //t_int scramLen, scramMeth // scramMeth: 0 = no repeats, 1 = allow repeats
-//reverting to clockSeg~ working scramble routine as the new one isn't working
-t_int scrambleSwaps(t_polyMath_tilde *x, t_int slot, t_int varOffset, t_int var, t_int len, t_float prob, t_int grpOffset)
+/* Join runs (unit 0) or whole groups (unit 1) of the base sequence (src 0) or of variation src are
+ * scrambled as blocks. The blocks to move are picked by a partial Fisher-Yates shuffle:
+ * round(2 * prob * blocks) of them for mode 0, exactly prob of them for mode 1, all of them for
+ * mode 2. They are then permuted among their own positions - as a single cycle (Sattolo) for modes 1 and 2
+ * and for scramMeth 0, so that every picked block changes place, or freely for scramMeth 1 in mode 0 (repeats
+ * allowed, a block may stay put). Blocks of unequal length can still land on their own start (A1 B1 C2 D2
+ * ordered D C A B leaves C at element 2), so mode 2 then swaps such a block with the next one (the last one
+ * with the one before it): after that no element of the sequence stays where it was. Mode 1 cannot displace
+ * exactly one block and refuses k = 1.
+ * The element moves are written to swapsRef for scrambleSeq. O(len), no retries.
+ */
+t_int scrambleSwaps(t_polyMath_tilde *x, t_int slot, t_int len, t_float prob, t_int mode, t_int unit, t_int srcVar)
 {
+  t_int nBlocks, picked, i, j, tmp, src, dst, r, run;
+  t_atom *join = srcVar > 0 ? x->var.eJoin : x->seq.eJoin;
+  t_atom *gStep = srcVar > 0 ? x->var.groupStep : x->seq.groupStep;
+  t_int from = srcVar > 0 ? slot * MAXSEQ + (srcVar - 1) * x->SEQSIZE : slot * MAXSEQ;
+  t_int size = srcVar > 0 ? x->VARSIZE : x->SEQSIZE;
   x->swapWell = 1;
-  x->seqLen = x->var.len[slot + var * SLOTS];
-  x->fSeqLen = (t_float)x->seqLen;
-  x->fHalfSeq = x->fSeqLen * 0.5;
-  x->halfSeq = x->seqLen / 2;
-  //if(x->scramMeth == 0) x->swapsNum = 
-  for(x->q = 0; x->q < x->seqLen; x->q++)
-    {
-      x->vGrp.swapped[x->q] = 0;
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->q, x->SEQSIZE, x->seq.eJoin);
-      if(x->swapVal > 1)
-	{
-	  x->vGrp.swaps[x->q] = x->q * -1;
-	  while(x->swapVal > 1)
-	    {
-	      x->q++;
-	      x->vGrp.swaps[x->q] = MAXSEQ * -1;
-	      x->swapVal--;
-	    }
-	}
+  x->seqLen = len;
+  nBlocks = 0;
+  for(x->q = 0; x->q < x->seqLen; x->q += run)
+    {
+      x->swapVal = atom_getfloatarg(from + x->q, size, join);
+      run = x->swapVal > 1 ? (t_int)x->swapVal : 1;
+      if(x->q + run > x->seqLen) run = x->seqLen - x->q;
+      // a group block runs on until the next join run that starts a group
+      if(unit && nBlocks > 0 && atom_getfloatarg(from + x->q, size, gStep) != 0) x->vGrp.blockLen[nBlocks - 1] += run;
       else
 	{
-	  x->vGrp.swaps[x->q] = x->q;
+	  x->vGrp.blockStart[nBlocks] = x->q;
+	  x->vGrp.blockLen[nBlocks] = run;
+	  x->vGrp.blockPick[nBlocks] = nBlocks;
+	  x->vGrp.blockOrder[nBlocks] = nBlocks;
+	  nBlocks++;
 	}
     }
-  if(x->scramMeth == 0)
+  // prob arrives halved (pairs of swaps in the old engine) - here it is the share of blocks displaced
+  if(mode == 2) picked = nBlocks;
+  else if(mode == 1) picked = (t_int)prob;
+  else picked = (t_int)((t_float)nBlocks * prob * 2 + 0.5);
+  picked = picked > nBlocks ? nBlocks : picked < 0 ? 0 : picked;
+  if(picked == 1 && mode == 1)
+    {
+      post("scramble: exactly one block cannot be displaced on its own - nothing scrambled");
+      return(0);
+    }
+  if(picked == 1) picked = nBlocks > 1 ? 2 : 0; // one block cannot be displaced on its own
+  for(i = 0; i < picked; i++)
+    {
+      j = i + (t_int)(pmRandom(x) * (double)(nBlocks - i));
+      if(j >= nBlocks) j = nBlocks - 1;
+      tmp = x->vGrp.blockPick[i];
+      x->vGrp.blockPick[i] = x->vGrp.blockPick[j];
+      x->vGrp.blockPick[j] = tmp;
+    }
+  for(i = 0; i < picked; i++) x->vGrp.swapped[i] = x->vGrp.blockPick[i];
+  for(i = picked - 1; i > 0; i--)
+    {
+      if(x->scramMeth == 0 || mode > 0) j = (t_int)(pmRandom(x) * (double)i);
+      else j = (t_int)(pmRandom(x) * (double)(i + 1));
+      if(j > i) j = i;
+      tmp = x->vGrp.swapped[i];
+      x->vGrp.swapped[i] = x->vGrp.swapped[j];
+      x->vGrp.swapped[j] = tmp;
+    }
+  for(i = 0; i < picked; i++) x->vGrp.blockOrder[x->vGrp.blockPick[i]] = x->vGrp.swapped[i];
+  // mode 2: a block that lands on its own start swaps with its neighbour, which cannot land on its own
+  if(mode == 2 && nBlocks > 1)
+    for(i = 0, dst = 0; i < nBlocks; i++)
+      {
+	if(x->vGrp.blockStart[x->vGrp.blockOrder[i]] == dst)
+	  {
+	    j = i < nBlocks - 1 ? i + 1 : i - 1;
+	    tmp = x->vGrp.blockOrder[i];
+	    x->vGrp.blockOrder[i] = x->vGrp.blockOrder[j];
+	    x->vGrp.blockOrder[j] = tmp;
+	  }
+	dst += x->vGrp.blockLen[x->vGrp.blockOrder[i]];
+      }
+  // blocks of different lengths shift everything between them, so list every element that moved
+  x->doSwaps = 0;
+  dst = 0;
+  for(i = 0; i < nBlocks; i++)
     {
-      x->randNum1 = drand48();
-      x->fSwapsNum = x->fSeqLen * prob;
-      x->swapsNum = rounder(x,x->fSwapsNum,x->seqLen - 1);
-      x->doSwaps = x->swapsNum;
-      //x->doSwaps = x->swapsNum = (t_int)x->fSwapsNum;
-      //if(x->fSwapsNum > (t_float)x->swapsNum && x->fSeqLen > x->fSwapsNum) x->extraSwapFlag = 1;
-      //else x->extraSwapFlag = 0;
-      x->r = 0;
-      if(x->scramMeth == 0) // 3rd January 2018 - have yet to take account of joins in this!
+      src = x->vGrp.blockOrder[i];
+      for(r = 0; r < x->vGrp.blockLen[src]; r++)
 	{
-	  //while(x->swapsNum)
-	  for(x->u = 0; x->u < x->swapsNum; x->u)
+	  x->vGrp.swaps[dst] = x->vGrp.blockStart[src] + r;
+	  if(x->vGrp.blockStart[src] + r != dst)
 	    {
-	      x->randNum2 = drand48();
-	      x->randNum3 = drand48();
-	      x->swapVal1 = (t_int)((t_float)x->randNum2 * x->fSeqLen);
-	      x->swapVal2 = (t_int)((t_float)x->randNum3 * x->fSeqLen);
-	      // May 30th 2021 - what is the > (MAXSEQ * -1) for? Can we get rid of it? does x->scramMeth refer to repeats?
-	      if(x->swapVal1 != x->swapVal2 && x->vGrp.swapped[x->swapVal1] == 0 && x->vGrp.swapped[x->swapVal2] == 0 && x->vGrp.swaps[x->swapVal1])// > (MAXSEQ * -1) && x->vGrp.swaps[x->swapVal2] > (MAXSEQ * -1))
-		{
-		  // how do we deal with joins here?
-		  x->vGrp.swapped[x->swapVal1] = 1;
-		  x->vGrp.swapped[x->swapVal2] = 1;
-		  x->vGrp.swaps[x->swapVal2] = x->swapVal1;
-		  x->vGrp.swaps[x->swapVal1] = x->swapVal2;
-		  x->vGrp.swapsRef[x->r] = x->swapVal1;
-		  x->vGrp.swapsRef[x->r + MAXSEQ] = x->swapVal2;
-		  x->r++;
-		  //x->swapsNum--;
-		  x->u++;
-		  if(x->swapVal1 < 0)
-		    {
-		      x->s = x->swapVal1 * -1 - 1;
-		      x->t = 1;
-		      while(x->s)
-			{
-			  x->vGrp.swaps[x->swapVal2 + x->t] = MAXSEQ * -1;
-			  x->vGrp.swaps[x->swapVal1 + x->t] = x->swapVal1 + x->t;
-			  x->s--;
-			}
-		    }
-		  else if(x->swapVal2 < 0)
-		    {
-		      x->s = x->swapVal2 * -1 - 1;
-		      x->t = 1;
-		      while(x->s)
-			{
-			  x->vGrp.swaps[x->swapVal1 + x->t] = MAXSEQ * -1;
-			  x->vGrp.swaps[x->swapVal2 + x->t] = x->swapVal2 + x->t;
-			  x->s--;
-			}
-		    }
-		}
+	      x->vGrp.swapsRef[x->doSwaps] = x->vGrp.blockStart[src] + r;
+	      x->vGrp.swapsRef[x->doSwaps + MAXSEQ] = dst;
+	      x->doSwaps++;
 	    }
+	  dst++;
 	}
     }
-  //January 3rd 2018 - have yet to write x->scramMeth == 1
+  x->swapsNum = picked;
+  if(dst != x->seqLen) x->swapWell = 0;
   return(x->swapWell);
 }
-//here is the newer version:
-/*t_int scrambleSwaps(t_polyMath_tilde *x, t_int slot, t_int varOffset, t_int var, t_int len, t_float prob, t_int grpOffset)
+
+/* BACKGROUND SCRAMBLE
+ * scramble requests are queued; the permutation is drawn by scrambleSwaps on Pd's thread (so that the random
+ * stream stays in order), then copySeq, scrambleSeq, regroup and varOffsets are done by the worker on a
+ * private copy. Nothing on the worker side touches x-> apart from the build buffer, mutex and cond.
+ */
+// worker side: copySeq + scrambleSeq + regroup + varOffsets on the build buffer only
+static t_int buildVariation(t_varBuild *b)
 {
-  x->swapWell = 1;
-  x->seqLen = x->var.len[slot + var * SLOTS];
-  x->fSeqLen = (t_float)x->seqLen;
-  x->fHalfSeq = x->fSeqLen * 0.5;
-  x->halfSeq = x->seqLen / 2;
-  //if(x->scramMeth == 0) x->swapsNum = 
-  for(x->q = 0; x->q < x->seqLen; x->q++)
-    {
-      x->vGrp.swapped[x->q] = 0;
-      x->swapVal = atom_getfloatarg(slot * MAXSEQ + x->q, x->SEQSIZE, x->seq.eJoin);
-      if(x->swapVal > 1)
-	{
-	  x->vGrp.swaps[x->q] = x->q * -1;
-	  while(x->swapVal > 1)
+  t_atom *src = b->src;
+  t_atom *dst = b->dst;
+  t_int f, q, p, from, to, gNum, gCount;
+  t_float eSize, eOff, vStep, den, gSize, gOff, oNext, vLast, lastD, off, gOffset;
+  t_int well = 1;
+  for(f = 0; f < SRCFIELDS; f++) memcpy(dst + f * MAXSEQ, src + f * MAXSEQ, b->len * sizeof(t_atom));
+  for(q = 0; q < b->doSwaps; q++)
+    {
+      from = b->swapsRef[q];
+      to = b->swapsRef[q + MAXSEQ];
+      for(f = 1; f < SRCFIELDS; f++) dst[f * MAXSEQ + to] = src[f * MAXSEQ + from]; // varStep (f = 1) follows the moved event
+    }
+  //regroup
+  gNum = gCount = 0;
+  gSize = gOff = oNext = vLast = lastD = 0;
+  for(p = 0; p < b->len && well; p++)
+    {
+      eSize = atom_getfloatarg(4 * MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst);
+      eOff = atom_getfloatarg(5 * MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst);
+      vStep = atom_getfloatarg(MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst);
+      den = atom_getfloatarg(9 * MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst);
+      if(eSize <= 0 || den == 0 || atom_getfloatarg(7 * MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst) == 0) well = 0;
+      else if(p == 0 || eOff != oNext || vStep != vLast + 1 || den != lastD)
+	{
+	  if(p > 0) gNum++;
+	  if(gNum >= GROUPS) well = 0;
+	  else
 	    {
-	      x->q++;
-	      x->vGrp.swaps[x->q] = MAXSEQ * -1;
-	      x->swapVal--;
+	      gCount = 0;
+	      gSize = eSize;
+	      gOff = eOff;
+	      b->gStart[gNum] = (t_int)vStep;
 	    }
 	}
       else
 	{
-	  x->vGrp.swaps[x->q] = x->q;
+	  gCount++;
+	  gSize += eSize;
 	}
-    }
-  x->randNum1 = drand48();
-  x->fSwapsNum = x->fSeqLen * prob;
-  x->swapsNum = rounder(x,x->fSwapsNum,x->seqLen - 1);
-  x->doSwaps = x->swapsNum;
-  //x->doSwaps = x->swapsNum = (t_int)x->fSwapsNum;
-  //if(x->fSwapsNum > (t_float)x->swapsNum && x->fSeqLen > x->fSwapsNum) x->extraSwapFlag = 1;
-  //else x->extraSwapFlag = 0;
-  x->r = 0;
-  // 3rd January 2018 - have yet to take account of joins in this!
-  //while(x->swapsNum)
-  for(x->u = 0; x->u < x->swapsNum; x->u++)
-    {
-      x->randNum2 = drand48();
-      x->randNum3 = drand48();
-      x->swapVal1 = (t_int)((t_float)x->randNum2 * x->fSeqLen);
-      x->swapVal2 = (t_int)((t_float)x->randNum3 * x->fSeqLen);
-      if(x->scramMeth == 0)
+      if(well)
 	{
-	  if(x->swapVal1 != x->swapVal2 && x->vGrp.swapped[x->swapVal1] == 0 && x->vGrp.swapped[x->swapVal2] == 0 && x->vGrp.swaps[x->swapVal1] > (MAXSEQ * -1) && x->vGrp.swaps[x->swapVal2] > (MAXSEQ * -1))
-	    {
-	      // how do we deal with joins here?
-	      x->vGrp.swapped[x->swapVal1] = 1;
-	      x->vGrp.swapped[x->swapVal2] = 1;
-	      x->vGrp.swaps[x->swapVal2] = x->swapVal1;
-	      x->vGrp.swaps[x->swapVal1] = x->swapVal2;
-	      x->vGrp.swapsRef[x->r] = x->swapVal1;
-	      x->vGrp.swapsRef[x->r + MAXSEQ] = x->swapVal2;
-	      x->r++;
-	      //x->swapsNum--;
-	      x->u++;
-	      if(x->swapVal1 < 0) // is this the join routine?
-		{
-		  x->s = x->swapVal1 * -1 - 1;
-		  x->t = 1;
-		  while(x->s)
-		    {
-		      x->vGrp.swaps[x->swapVal2 + x->t] = MAXSEQ * -1;
-		      x->vGrp.swaps[x->swapVal1 + x->t] = x->swapVal1 + x->t;
-		      x->s--;
-		    }
-		}
-	      else if(x->swapVal2 < 0)
-		{
-		  x->s = x->swapVal2 * -1 - 1;
-		  x->t = 1;
-		  while(x->s)
-		    {
-		      x->vGrp.swaps[x->swapVal1 + x->t] = MAXSEQ * -1;
-		      x->vGrp.swaps[x->swapVal2 + x->t] = x->swapVal2 + x->t;
-		      x->s--;
-		    }
-		}
-	    }
+	  SETFLOAT(&b->offset[gNum], gOff);
+	  SETFLOAT(&b->size[gNum], gSize);
+	  SETFLOAT(&b->sizeInv[gNum], 1 / gSize);
+	  SETFLOAT(&b->n[gNum], (t_float)gCount + 1);
+	  SETFLOAT(&b->d[gNum], den);
+	  SETFLOAT(&dst[2 * MAXSEQ + p], (t_float)gCount);
+	  SETFLOAT(&dst[3 * MAXSEQ + p], (t_float)gNum);
+	  oNext = eOff + eSize;
+	  vLast = vStep;
+	  lastD = den;
 	}
-      else if(x->scramMeth == 1)
+    }
+  b->nGroups = gNum + 1;
+  //varOffsets
+  off = gOffset = 0;
+  for(p = 0; p < b->len && well; p++)
+    {
+      SETFLOAT(&dst[26 * MAXSEQ + p], off);
+      if(atom_getfloatarg(2 * MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst) == 0) gOffset = off;
+      SETFLOAT(&dst[27 * MAXSEQ + p], gOffset);
+      off += atom_getfloatarg(4 * MAXSEQ + p, BUILDFIELDS * MAXSEQ, dst);
+    }
+  return(well);
+}
+
+static void *polyMath_tilde_buildThread(void *z)
+{
+  t_polyMath_tilde *x = (t_polyMath_tilde *)z;
+  t_int well;
+  pthread_mutex_lock(&x->buildMutex);
+  while(!x->buildQuit)
+    {
+      if(x->build->state != BUILD_REQUESTED)
 	{
-	  if(x->swapVal1 != x->swapVal2 && x->vGrp.swaps[x->swapVal1] > (MAXSEQ * -1) && x->vGrp.swaps[x->swapVal2] > (MAXSEQ * -1))
-	    {
-	      // how do we deal with joins here?
-	      x->vGrp.swapped[x->swapVal1] = 1;
-	      x->vGrp.swapped[x->swapVal2] = 1;
-	      x->vGrp.swaps[x->swapVal2] = x->swapVal1;
-	      x->vGrp.swaps[x->swapVal1] = x->swapVal2;
-	      x->vGrp.swapsRef[x->r] = x->swapVal1;
-	      x->vGrp.swapsRef[x->r + MAXSEQ] = x->swapVal2;
-	      x->r++;
-	      //x->swapsNum--;
-	      x->u++;
-	      if(x->swapVal1 < 0) // is this the join routine?
-		{
-		  x->s = x->swapVal1 * -1 - 1;
-		  x->t = 1;
-		  while(x->s)
-		    {
-		      x->vGrp.swaps[x->swapVal2 + x->t] = MAXSEQ * -1;
-		      x->vGrp.swaps[x->swapVal1 + x->t] = x->swapVal1 + x->t;
-		      x->s--;
-		    }
-		}
-	      else if(x->swapVal2 < 0)
-		{
-		  x->s = x->swapVal2 * -1 - 1;
-		  x->t = 1;
-		  while(x->s)
-		    {
-		      x->vGrp.swaps[x->swapVal1 + x->t] = MAXSEQ * -1;
-		      x->vGrp.swaps[x->swapVal2 + x->t] = x->swapVal2 + x->t;
-		      x->s--;
-		    }
-		}
-	    }
+	  pthread_cond_wait(&x->buildCond, &x->buildMutex);
+	  continue;
 	}
+      pthread_mutex_unlock(&x->buildMutex);
+      well = buildVariation(x->build);
+      pthread_mutex_lock(&x->buildMutex);
+      x->build->well = well;
+      x->build->state = BUILD_DONE;
     }
-  //January 3rd 2018 - have yet to write x->scramMeth == 1
-  return(x->swapWell);
-  }*/
+  pthread_mutex_unlock(&x->buildMutex);
+  return(0);
+}
+
+static void buildReport(t_polyMath_tilde *x, t_int slot, t_int var, t_int well)
+{
+  SETFLOAT(&x->buildList[0], (t_float)slot);
+  SETFLOAT(&x->buildList[1], (t_float)var);
+  SETFLOAT(&x->buildList[2], (t_float)well);
+  outlet_float(x->dType, 89);
+  outlet_anything(x->dataOut, gensym("scrambled"), 3, x->buildList);
+}
+
+// one result of a scrambleAll batch - the batch reports once, when its last scramble is done
+static void batchCheck(t_polyMath_tilde *x)
+{
+  if(x->batchOpen || x->batchDone < x->batchPending) return;
+  SETFLOAT(&x->buildList[0], (t_float)x->batchPending);
+  SETFLOAT(&x->buildList[1], (t_float)x->batchOk);
+  outlet_float(x->dType, 89);
+  outlet_anything(x->dataOut, gensym("scrambledAll"), 2, x->buildList);
+  x->batchPending = x->batchDone = x->batchOk = 0;
+}
+
+static void batchReport(t_polyMath_tilde *x, t_int well)
+{
+  x->batchDone++;
+  x->batchOk += well;
+  batchCheck(x);
+}
+
+// Pd's thread: take the next queued scramble, draw its permutation, snapshot the slot and wake the worker
+static void buildNext(t_polyMath_tilde *x)
+{
+  t_varBuild *b = x->build;
+  t_int slot, var, len, f, batch, srcOffset, src, mode, unit;
+  t_float prob;
+  while(x->scramQCount > 0)
+    {
+      slot = x->scramQSlot[x->scramQHead];
+      var = x->scramQVar[x->scramQHead];
+      prob = x->scramQProb[x->scramQHead];
+      batch = x->scramQBatch[x->scramQHead];
+      src = x->scramQSrc[x->scramQHead];
+      mode = x->scramQMode[x->scramQHead];
+      unit = x->scramQUnit[x->scramQHead];
+      x->scramQHead = (x->scramQHead + 1) % SCRAMQUEUE;
+      x->scramQCount--;
+      if(src > 0 && x->var.variations[slot + (src - 1) * SLOTS] == 0) len = 0;
+      else len = src > 0 ? x->var.len[slot + (src - 1) * SLOTS] : x->seq.len[slot];
+      if(len < 1 || !scrambleSwaps(x, slot, len, prob, mode, unit, src))
+	{
+	  if(batch) batchReport(x, 0);
+	  else buildReport(x, slot, var, 0);
+	  continue;
+	}
+      x->buildBatch = batch;
+      b->slot = slot;
+      b->var = var;
+      b->len = len;
+      b->cycles = src > 0 ? x->vGrp.cycles[slot + (src - 1) * SLOTS] : x->grp.cycles[slot];
+      b->doSwaps = x->doSwaps;
+      memcpy(b->swapsRef, x->vGrp.swapsRef, x->doSwaps * sizeof(t_int));
+      memcpy(b->swapsRef + MAXSEQ, x->vGrp.swapsRef + MAXSEQ, x->doSwaps * sizeof(t_int));
+      srcOffset = src > 0 ? slot * MAXSEQ + (src - 1) * x->SEQSIZE : slot * MAXSEQ;
+      for(f = 0; f < SRCFIELDS; f++) memcpy(b->src + f * MAXSEQ, buildField(x, src > 0, f) + srcOffset, len * sizeof(t_atom));
+      pthread_mutex_lock(&x->buildMutex);
+      b->state = BUILD_REQUESTED;
+      pthread_cond_signal(&x->buildCond);
+      pthread_mutex_unlock(&x->buildMutex);
+      clock_delay(x->buildOut, 1);
+      return;
+    }
+}
+
+// Pd's thread: poll the worker and publish a finished variation between two DSP ticks
+void polyMath_tilde_buildOut(t_polyMath_tilde *x)
+{
+  t_varBuild *b = x->build;
+  t_int v, f, varOffset, grpOffset;
+  if(pthread_mutex_trylock(&x->buildMutex) != 0)
+    {
+      clock_delay(x->buildOut, 1);
+      return;
+    }
+  if(b->state != BUILD_DONE)
+    {
+      pthread_mutex_unlock(&x->buildMutex);
+      clock_delay(x->buildOut, 1);
+      return;
+    }
+  b->state = BUILD_IDLE;
+  pthread_mutex_unlock(&x->buildMutex);
+  v = b->var - 1;
+  if(b->well && b->var > VARIATIONS)
+    {
+      if(poolVar(x, b->slot, b->var) == 0 || !storeFromBuild(b, poolVar(x, b->slot, b->var))) b->well = 0;
+    }
+  else if(b->well)
+    {
+      varOffset = b->slot * MAXSEQ + v * x->SEQSIZE;
+      grpOffset = b->slot * GROUPS + v * x->GROUPSIZE;
+      undoSave(x, x->buildBatch ? x->batchStep : undoNext(x), b->slot, b->var, 0, 0, 1, UNDO_ALL);
+      for(f = 0; f < BUILDFIELDS; f++) memcpy(buildField(x, 1, f) + varOffset, b->dst + f * MAXSEQ, b->len * sizeof(t_atom));
+      memcpy(x->vGrp.gStart + grpOffset, b->gStart, b->nGroups * sizeof(t_int));
+      memcpy(x->vGrp.n + grpOffset, b->n, b->nGroups * sizeof(t_atom));
+      memcpy(x->vGrp.d + grpOffset, b->d, b->nGroups * sizeof(t_atom));
+      memcpy(x->vGrp.offset + grpOffset, b->offset, b->nGroups * sizeof(t_atom));
+      memcpy(x->vGrp.size + grpOffset, b->size, b->nGroups * sizeof(t_atom));
+      memcpy(x->vGrp.sizeInv + grpOffset, b->sizeInv, b->nGroups * sizeof(t_atom));
+      x->vGrp.nGroups[b->slot + v * SLOTS] = b->nGroups;
+      x->vGrp.cycles[b->slot + v * SLOTS] = b->cycles;
+      x->var.len[b->slot + v * SLOTS] = b->len;
+      x->var.variations[b->slot + v * SLOTS] = 1;
+      markDirty(x, b->slot, b->var, -1, 0, b->len - 1);
+    }
+  if(x->buildBatch) batchReport(x, b->well);
+  else buildReport(x, b->slot, b->var, b->well);
+  buildNext(x);
+}
+
+// src: source variation (0 = the slot's sequence); mode, unit: see scrambleSwaps
+static t_int queueScramble(t_polyMath_tilde *x, t_int slot, t_int src, t_int var, t_float prob, t_int mode, t_int unit, t_int batch)
+{
+  t_int i;
+  if(x->grpFixGroup[slot] >= 0) groupFixSlot(x, slot);
+  if(x->scramQCount >= SCRAMQUEUE)
+    {
+      if(!batch) post("scramble queue is full - slot %d variation %d was not scrambled", slot, var);
+      return(0);
+    }
+  i = (x->scramQHead + x->scramQCount) % SCRAMQUEUE;
+  x->scramQSlot[i] = slot;
+  x->scramQVar[i] = var;
+  x->scramQProb[i] = prob;
+  x->scramQBatch[i] = batch;
+  x->scramQSrc[i] = src;
+  x->scramQMode[i] = mode;
+  x->scramQUnit[i] = unit;
+  x->scramQCount++;
+  if(batch) x->batchPending++;
+  pthread_mutex_lock(&x->buildMutex);
+  if(x->build->state == BUILD_IDLE)
+    {
+      pthread_mutex_unlock(&x->buildMutex);
+      buildNext(x);
+    }
+  else pthread_mutex_unlock(&x->buildMutex);
+  return(1);
+}
 
 void polyMath_tilde_noRepeats(t_polyMath_tilde *x, t_floatarg f)
 {
   x->noRepeats = f !=0 ? 1 : 0;
 }
 
+/* the old, synchronous scramble of x->scramSlot into x->variation (1 - VARIATIONS), used when there is no
+ * worker thread - mode: see scrambleSwaps, quiet: no progress posts (scrambleAll reports once for the
+ * whole batch). 1 = scrambled
+ */
+static t_int scrambleInPlace(t_polyMath_tilde *x, t_int mode, t_int quiet)
+{
+  if(x->grpFixGroup[x->scramSlot] >= 0) groupFixSlot(x, x->scramSlot);
+  x->seqLen = x->seq.len[x->scramSlot];
+  if(x->myBug == 9) post("x->seqLen = %d", x->seqLen);
+  x->thisVar = x->variation - 1;
+  undoSave(x, x->batchOpen ? x->batchStep : undoNext(x), x->scramSlot, x->variation, 0, 0, 1, UNDO_ALL);
+  x->var.len[x->scramSlot + x->thisVar * SLOTS] = x->seqLen;
+  x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
+  if(x->myBug == 15)
+    {
+      post("SCRAMBLE VALUES:");
+      post("x->scramSlot = %d",x->scramSlot);
+      post("x->thisVar = %d",x->thisVar);
+    }
+  x->grpOffset = x->scramSlot * GROUPS + x->GROUPSIZE * x->thisVar;
+  if(x->myBug == 9) post("x->offsetVar = %d, x->seqLen = %d",x->offsetVar,x->seqLen);
+  if(copySeq(x,x->scramSlot,x->offsetVar) != 1)
+    {
+      if(!quiet) post("copy sequence unsuccessful ;-(");
+      return(0);
+    }
+  if(!quiet) post("Sequence copied successfully!");
+  if(!scrambleSwaps(x,x->scramSlot,x->seqLen,x->seqProb,mode,0,0))
+    {
+      if(!quiet) post("Swaplist compilation unsuccessful ;-(");
+      return(0);
+    }
+  if(!quiet) post("Swaplists compiled!");
+  if(!scrambleSeq(x,x->offsetVar,x->scramSlot))
+    {
+      if(!quiet) post("Scrambling unsuccessful ;-(");
+      return(0);
+    }
+  if(!quiet) post("Scrambling successful!");
+  if(!regroup(x,x->grpOffset,x->offsetVar,x->scramSlot,x->thisVar,x->seqLen))
+    {
+      if(!quiet) post("Re-grouping unsuccessful ;-(");
+      return(0);
+    }
+  if(!quiet) post("Re-grouping successful!");
+  if(!varOffsets(x,x->offsetVar,x->seqLen))
+    {
+      if(!quiet) post("Var offset writing unsuccessful ;-(");
+      return(0);
+    }
+  if(!quiet) post("Var offsets for instant written successfully");
+  x->var.variations[x->scramSlot + x->thisVar * SLOTS] = 1;
+  markDirty(x, x->scramSlot, x->variation, -1, 0, x->seqLen - 1);
+  return(1);
+}
+
 void polyMath_tilde_scramble(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
+  t_int mode = 0;
   if(argc < 1 && argc > 3)
     {
       post("Incorrect arguments to scramble!");
     }
   else
     {
-      if(argc == 3)
+      if(argc == 4)
+	{
+	  // slot var amount mode - mode 1: amount is the exact number of events (join runs) displaced, mode 2: all displaced
+	  x->scramSlot = (t_int)atom_getfloat(argv);
+	  x->scramSlot = x->scramSlot < 0 ? 0 : x->scramSlot >= SLOTS ?  SLOTS - 1 : x->scramSlot;
+	  x->variation = (t_int)atom_getfloat(argv+1);
+	  x->variation = x->variation < 0 ? 0 : x->variation > VARIATIONS + x->poolSize[x->scramSlot] ? VARIATIONS : x->variation;
+	  mode = (t_int)atom_getfloat(argv+3);
+	  mode = mode < 0 ? 0 : mode > 2 ? 2 : mode;
+	  x->seqProb = atom_getfloat(argv+2);
+	  if(mode == 0) x->seqProb = (x->seqProb < 0 ? 0 : x->seqProb > 1 ? 1 : x->seqProb) * 0.5;
+	}
+      else if(argc == 3)
 	{
 	  x->scramSlot = (t_int)atom_getfloat(argv);
 	  x->scramSlot = x->scramSlot < 0 ? 0 : x->scramSlot >= SLOTS ?  SLOTS - 1 : x->scramSlot;
 	  x->variation = (t_int)atom_getfloat(argv+1);
-	  x->variation = x->variation < 0 ? 0 : x->variation > VARIATIONS ? VARIATIONS : x->variation;
+	  x->variation = x->variation < 0 ? 0 : x->variation > VARIATIONS + x->poolSize[x->scramSlot] ? VARIATIONS : x->variation;
 	  x->seqProb = atom_getfloat(argv+2);
 	  x->seqProb = x->seqProb < 0 ? 0 : x->seqProb > 1 ? 1 : x->seqProb;
 	  x->seqProb *= 0.5;
@@ -3562,56 +5461,120 @@ void polyMath_tilde_scramble(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_ato
       //	  post("length = %d",length);
       /* We're going to have to watch it here. The value of x->variation will stay the same if the slot is changed */
       if(x->variation == 0) post("You cannot scramble the original sequence (i.e. variation 0)");
+      else if(x->buildThreadOk) queueScramble(x, x->scramSlot, 0, x->variation, x->seqProb, mode, 0, 0);
+      else if(x->variation > VARIATIONS) post("scrambling into the variation pool needs the worker thread");
       // joined elements should stay joined, so that the value of seqLen will take this into account
       /* int offsetVar, scramSlot, seqLen, remainSeq, o, p, copyWell, scramWell, joinElement, oldLoc, newLoc, scramMeth
        * t_float swapVal, copyVal, seqProbVal, seqRemainRounding
        * double randNum
        *
        */
+      else scrambleInPlace(x, mode, 0);
+    }
+}
+
+/* scrambleGroups slot var destVar [amount [mode]]: whole groups of the sequence (var 0) or of a variation are
+ * shuffled into destVar. Joined events stay together even across group boundaries.
+ * mode 0: amount (0 - 1) is the share of groups displaced (default when amount is given)
+ * mode 1: exactly amount groups are displaced
+ * mode 2: every group is displaced, none ends up where it was (default with no amount)
+ * The permutation comes from scrambleSwaps and is built like any other scramble, on the worker thread.
+ */
+void polyMath_tilde_groupScramble(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  x->GSScramRand = 0.5;
+  if(argc < 3 || argc > 5)
+    {
+      post("scrambleGroups takes slot, var, destVar [, amount [, mode]]");
+      return;
+    }
+  x->GSSlot = (t_int)atom_getfloat(argv+0);
+  x->GSVar = (t_int)atom_getfloat(argv+1);
+  x->GSDestVar = (t_int)atom_getfloat(argv+2);
+  x->GSMode = argc == 3 ? 2 : argc == 5 ? (t_int)atom_getfloat(argv+4) : 0;
+  if(argc > 3) x->GSScramRand = atom_getfloat(argv+3);
+  if(x->GSSlot >= SLOTS || x->GSSlot < 0) post("slot must be a whole number from 0 to %d",SLOTS - 1);
+  else if(x->GSVar < 0 || x->GSVar > VARIATIONS) post("var must bo 0 (no-var) or a whole number from 1 to %d",VARIATIONS);
+  else if(x->GSDestVar < 1 || x->GSDestVar > VARIATIONS + x->poolSize[x->GSSlot]) post("dest var must be a whole number from 1 to %d",VARIATIONS + x->poolSize[x->GSSlot]);
+  else if(x->GSMode < 0 || x->GSMode > 2) post("mode must be 0 (probability), 1 (exact number) or 2 (all)");
+  else if(x->GSMode == 0 && (x->GSScramRand < 0 || x->GSScramRand > 1)) post("randomness must be a floating point number from 0 to 1");
+  else if(x->GSMode == 1 && x->GSScramRand < 0) post("number of groups to displace must not be negative");
+  else if(x->GSVar == x->GSDestVar) post("destination variation must not be the same as source variation");
+  // later on mybe we could make a "scramble-in-place"
+  else if(!x->buildThreadOk) post("scrambleGroups needs the worker thread");
+  else queueScramble(x, x->GSSlot, x->GSVar, x->GSDestVar, x->GSMode == 0 ? x->GSScramRand * 0.5 : x->GSScramRand, x->GSMode, 1, 0);
+}
+
+/* scrambleAll var prob [slotFrom slotTo]: scramble one variation of every defined slot in the range
+ * scrambleAll slot var prob slot var prob ...: scramble each listed slot/variation
+ * Everything goes through the worker's queue, and the whole batch answers with a single
+ * "scrambledAll <queued> <scrambled>" (dType 89) instead of one report per scramble.
+ */
+void polyMath_tilde_scrambleAll(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, var, from, to, i, range, lost = 0, bad = 0;
+  t_float prob;
+  if(argc == 2 || argc == 4)
+    {
+      range = 1;
+      from = argc == 4 ? (t_int)atom_getfloat(argv+2) : 0;
+      to = argc == 4 ? (t_int)atom_getfloat(argv+3) : SLOTS - 1;
+      from = from < 0 ? 0 : from >= SLOTS ? SLOTS - 1 : from;
+      to = to < from ? from : to >= SLOTS ? SLOTS - 1 : to;
+    }
+  else if(argc > 0 && argc % 3 == 0)
+    {
+      range = 0;
+      from = 0;
+      to = argc / 3 - 1;
+    }
+  else
+    {
+      post("scrambleAll takes: variation probability [slotFrom slotTo], or a list of slot variation probability");
+      return;
+    }
+  x->batchOpen = 1;
+  x->batchStep = ++x->undoStep;
+  for(i = from; i <= to; i++)
+    {
+      if(range)
+	{
+	  slot = i;
+	  var = (t_int)atom_getfloat(argv);
+	  prob = atom_getfloat(argv+1);
+	  if(x->seq.len[slot] < 1) continue;
+	}
       else
 	{
-	  x->seqLen = x->seq.len[x->scramSlot];
-	  if(x->myBug == 9) post("x->seqLen = %d", x->seqLen);
-	  x->thisVar = x->variation - 1;
-	  x->var.len[x->scramSlot + x->thisVar * SLOTS] = x->seqLen;
-	  x->offsetVar = x->scramSlot * MAXSEQ + x->thisVar * x->SEQSIZE;
-	  if(x->myBug == 15)
-	    {
-	      post("SCRAMBLE VALUES:");
-	      post("x->scramSlot = %d",x->scramSlot);
-	      post("x->thisVar = %d",x->thisVar);
-	    }
-	  x->grpOffset = x->scramSlot * GROUPS + x->GROUPSIZE * x->thisVar;
-	  //x->offsetVar = x->scramSlot * MAXSEQ + SLOTS * MAXSEQ * x->thisVar;
-	  if(x->myBug == 9) post("x->offsetVar = %d, x->seqLen = %d",x->offsetVar,x->seqLen);
-	  if(copySeq(x,x->scramSlot,x->offsetVar) == 1)
-	    {
-	      post("Sequence copied successfully!");
-	      if(scrambleSwaps(x,x->scramSlot,x->offsetVar,x->thisVar,x->seqLen,x->seqProb,x->grpOffset))
-		{
-		  post("Swaplists compiled!");
-		  if(scrambleSeq(x,x->offsetVar,x->scramSlot))
-		    {
-		      post("Scrambling successful!");
-		      if(regroup(x,x->grpOffset,x->offsetVar,x->scramSlot,x->thisVar,x->seqLen))
-			{
-			  post("Re-grouping successful!");
-			  if(varOffsets(x,x->offsetVar,x->seqLen))
-			    {
-			      post("Var offsets for instant written successfully");
-			      x->var.variations[x->slot + x->thisVar * SLOTS] = 1;
-			    }
-			  else post("Var offset writing unsuccessful ;-(");
-			}
-		      else post("Re-grouping unsuccessful ;-(");
-		    }
-		  else post("Scrambling unsuccessful ;-(");
-		}
-	      else post("Swaplist compilation unsuccessful ;-(");
-	    }
-	  else post("copy sequence unsuccessful ;-(");
+	  slot = (t_int)atom_getfloat(argv + i * 3);
+	  var = (t_int)atom_getfloat(argv + i * 3 + 1);
+	  prob = atom_getfloat(argv + i * 3 + 2);
+	}
+      if(slot < 0 || slot >= SLOTS || var < 1 || var > VARIATIONS + x->poolSize[slot])
+	{
+	  bad++;
+	  continue;
+	}
+      prob = prob < 0 ? 0 : prob > 1 ? 1 : prob;
+      if(x->buildThreadOk)
+	{
+	  if(!queueScramble(x, slot, 0, var, prob * 0.5, 0, 0, 1)) lost++;
+	}
+      else if(var <= VARIATIONS)
+	{
+	  // no worker: scramble in place, one at a time
+	  x->scramSlot = slot;
+	  x->variation = var;
+	  x->seqProb = prob * 0.5;
+	  x->batchPending++;
+	  batchReport(x, x->seq.len[slot] > 0 && scrambleInPlace(x, 0, 1));
 	}
+      else bad++;
     }
+  if(bad || lost) post("scrambleAll: %d invalid slot/variation pairs skipped, %d did not fit in the queue", bad, lost);
+  x->batchOpen = 0;
+  // nothing queued, or everything already finished while queueing
+  batchCheck(x);
 }
 
 void polyMath_tilde_scramMeth(t_polyMath_tilde *x, t_floatarg f)
@@ -3632,19 +5595,17 @@ void polyMath_tilde_preChange(t_polyMath_tilde *x, t_floatarg f) // note that th
 // JOINED ELEMENTS
 void polyMath_tilde_makeJoin(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
-  x->joinSuccess = 0;
+  if(txQueue(x, s, argc, argv)) return;
   // argv: slot, group, location, length - not yet: (, location2, length2 (, location3, length3 etc))
   //could be dicey...if we make a 3 then a 2, the 2 will be ignored
   // make sure we've got the right kind of list:
   if(argc < 4)
     {
       post("makeJoin: you need at least slot, group, location, length");
-      x->joinSuccess = 0;
     }
   else if((argc - 4) % 2 == 1)
     {
       post("makeJoin: each join requires at least location, length");
-      x->joinSuccess = 0;
     }
   else
     {
@@ -3672,28 +5633,26 @@ void polyMath_tilde_makeJoin(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_ato
 	      if(x->JLoc >= x->JGnm)
 		{
 		  post("makeJoin: location is after the group");
-		  x->joinSuccess = 0;
 		}
 	      else if(x->JLoc + x->JLen > x->JGnm)
 		{
 		  post("makeJoin: location + length is greater than the numerator");
-		  x->joinSuccess = 0;
 		}
 	      else if(x->JLoc < 0 || x->JLen <= 0 || x->JGnm <= 0)
 		{
 		  post("makeJoin: x->JLoc must be >= 0: %d",x->JLoc);
 		  post("makeJoin: x->JLen must be > 0: %d",x->JLen);
 		  post("makeJoin: x->JGnm must be > 0: %d",x->JGnm);
-		  x->joinSuccess = 0;
 		}
 	      else // here we go - write the value
 		{ // after, we might want to point out overlapping groups (if any)
 		  // and possibly have a "safe mode" where errors are sequentially removed e.g. 3 3 1 4 3 1 1 rewritten 3 1 1 4 1 1 1
 		  // actually that should be the default!
 		  x->JGst = x->grp.gStart[x->JSlot * GROUPS + x->JGrp];
+		  undoSave(x, undoNext(x), x->JSlot, 0, x->JLoc + x->JGst, x->JLen, 0, 1 << 6);
 		  if(x->myBug == 7) post("x->JGst = %d",x->JGst);
 		  SETFLOAT(&x->seq.eJoin[x->JLoc + x->JGst + x->JSlot * MAXSEQ],(t_float)x->JLen);
-		  for(x->j = x->JLoc + 1;x->j < x->JLen; x->j++)
+		  for(x->j = x->JLoc + 1;x->j < x->JLoc + x->JLen; x->j++)
 		    {
 		      /*if(x->j == 0)
 			{
@@ -3703,7 +5662,8 @@ void polyMath_tilde_makeJoin(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_ato
 			else*/
 		      SETFLOAT(&x->seq.eJoin[x->j + x->JGst + x->JSlot * MAXSEQ],1);
 		    }
-		  x-> joinSuccess = 1;
+		  markDirty(x, x->JSlot, 0, 4, x->JLoc + x->JGst, x->JLoc + x->JGst + x->JLen - 1);
+		  markDirty(x, x->JSlot, 0, 5, x->JLoc + x->JGst, x->JLoc + x->JGst + x->JLen - 1);
 		  // The above method should work if the joins are created in one direction then cleaned in another
 		  // ...but the consequences to which direction to make and which direction to clean are different.
 		  // If errors are found, best to create backwards and clean forwards.
@@ -3715,101 +5675,117 @@ void polyMath_tilde_makeJoin(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_ato
       else
 	{
 	  post("makeJoin: slot must be between 0 and %d",SLOTS - 1);
-	  x->joinSuccess = 0;
 	}
     }
-  if(x->joinSuccess == 1)
+  // no cleaning pass: overlapping runs are settled when the join cache is resolved
+}
+
+// setJoins slot group join1 join2 ...: the joins must add up to the numerator of the group. Each join is
+// written to the overlay (see JOIN CACHE), nothing after the group moves
+void polyMath_tilde_joinSeq(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, group, start, n, total, join, i, k;
+  if(txQueue(x, s, argc, argv)) return;
+  if(argc < 3)
+    {
+      post("setJoins: you need at least slot, group, join");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  group = (t_int)atom_getfloat(argv + 1);
+  if(slot < 0 || slot >= SLOTS)
+    {
+      post("setJoins: slot must be between 0 and %d", SLOTS - 1);
+      return;
+    }
+  if(group < 0 || group >= x->grp.nGroups[slot])
     {
-      // clean the group!
-      for(x->k = 0; x->k < x->JGn; x->k++)
+      post("setJoins: group must exist in sequence");
+      return;
+    }
+  n = (t_int)atom_getfloatarg(slot * GROUPS + group, x->GROUPSIZE, x->grp.n);
+  for(i = 2, total = 0; i < argc; i++)
+    {
+      join = (t_int)atom_getfloat(argv + i);
+      if(join < 1)
 	{
-	  x->JLen = (t_int)atom_getfloatarg(x->k + x->JSlot * MAXSEQ, x->SEQSIZE, x->seq.eJoin);
-	  if(x->JLen > 1)
-	    {
-	      for(x->j = 1; x->j < x->JLen; x->j++) SETFLOAT(&x->seq.eJoin[x->j + x->k + x->JSlot * MAXSEQ],1);
-	    }
-	  //when an N > 1 value is encountered sequentially, the subsequent N-1 values must be 1 
-	  SETFLOAT(&x->seq.jSize[x->k + x->JSlot * MAXSEQ],1/(t_float)x->JLen); // do we need this?
+	  post("setJoins: join must be >= 1");
+	  return;
 	}
-      x->joinSuccess = 0;
+      total += join;
+    }
+  if(total != n)
+    {
+      post("setJoins: joins add up to %d, group %d has %d events", total, group, n);
+      return;
+    }
+  start = x->grp.gStart[slot * GROUPS + group];
+  undoSave(x, undoNext(x), slot, 0, start, n, 0, 1 << 6);
+  for(i = 2, k = start; i < argc; i++)
+    {
+      join = (t_int)atom_getfloat(argv + i);
+      SETFLOAT(&x->seq.eJoin[slot * MAXSEQ + k], (t_float)join);
+      for(k++; --join > 0; k++) SETFLOAT(&x->seq.eJoin[slot * MAXSEQ + k], 1);
     }
+  markDirty(x, slot, 0, 4, start, start + n - 1);
 }
 
-//This one doesn't work yet
-void polyMath_tilde_joinSeq(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+// begin: start queueing edits (of any slot)
+void polyMath_tilde_begin(t_polyMath_tilde *x)
 {
-  if(argc > 2)
+  if(x->txOpen) post("begin: a transaction is already open");
+  else
     {
-      x->JSlot = (t_int)atom_getfloat(argv);
-      if(x->JSlot < 0 || x->JSlot > 127) post("ERROR: slot must be an integer from 0 to 127!");
-      else
-	{
-	  x->JGrp = (t_int)atom_getfloat(argv+1);
-	  if(x->grp.nGroups[x->JSlot] <= x->JGrp) post("ERROR: group must already exist in sequence!");
-	  else
-	    {
-	      if(x->myBug == 6) post("Into the main routine");
-	      x->GroupStart = x->grp.gStart[x->JGrp];
-	      x->JGd = atom_getfloatarg(x->JSlot * GROUPS + x->GroupStart, x->GROUPSIZE, x->grp.d);
-	      x->JGn = atom_getfloatarg(x->JSlot * GROUPS + x->GroupStart, x->GROUPSIZE, x->grp.n);
-	      x->JGnm = (t_int)x->JGn;
-	      x->JESize = x->JGn / x->JGd;
-	      x->Jointot = 0;
-	      for(x->g = 0; x->g < argc - 2; x->g++)
-		{
-		  x->Jointot += (t_int)atom_getfloat(argv + 2 + x->g);
-		}
-	      if(x->myBug == 6) post("Jointot = %d, JGn = %d, GroupStart = %d",x->Jointot,(t_int)x->JGn,x->GroupStart);
-	      x->JGn = atom_getfloatarg(x->JSlot * GROUPS + x->GroupStart, x->GROUPSIZE, x->grp.n);
-	      if(x->Jointot != (t_int)x->JGn)
-		{
-		  post("ERROR: Joins total is not equal to numerator!");
-		  if(x->myBug == 6)
-		    {
-		      for(x->k = 0; x->k < argc - 2;x->k++)
-			{
-			  post("%f",atom_getfloat(argv + 2 + x->k));
-			}
-		    }
-		}
-	      else
-		{
-		  x->JGt = 0;
-		  x->g = 0;
-		  for(x->k = 0; x->k < argc - 2;x->k++)
-		    {
-  		      /*while(x->Jointot > 0)
-			{ */
-		      if(x->myBug == 6) post("Into the while() statements!");
-		      x->JJoin = atom_getfloat(argv + 2 + x->g);
-		      if(x->JJoin > 1)
-			{
-			  x->Gstp++;
-			  SETFLOAT(&x->seq.eJoin[x->JSlot * MAXSEQ + x->GroupStart + x->g],x->JJoin);
-			  SETFLOAT(&x->seq.jSize[x->JSlot * MAXSEQ + x->GroupStart + x->g],x->JJoin * x->JESize);
-			  //SETFLOAT(&x->seq.eSize[x->JSlot * MAXSEQ + x->GroupStart + x->g],x->JJoin * x->JESize);
-			  //SETFLOAT(&x->seq.eSizeInv[x->JSlot * MAXSEQ + x->GroupStart + x->g],1/(x->JJoin * x->JESize));
-			  // at this point it will be necessary to re-write the rest of the sequence
-			  x->Jointot -= (t_int)x->JJoin;
-			  x->JGt += x->JJoin - 1;
-			  if(x->JJoin > 1)
-			    x->RW = reWriteSeq(x); // get x->JJoin and x->Gstp in reWriteGroups(x)
-			}
-		      else
-			post("ERROR: Join must be >= 1");
-		    }
-		  for(x->k = x->JGrp + 1; x->k < x->grp.nGroups[x->JSlot]; x->k++)
-		    {
-		      // reWrite the array in t_groups for gStart
-		      x->JGstt = x->grp.gStart[x->JSlot * GROUPS + x->k] - (t_int)x->JGt;
-		      x->grp.gStart[x->JSlot * GROUPS + x->k] = x->JGstt;
-		    }
-		}
-	    }
-	}		    
+      x->txOpen = 1;
+      x->txLen = x->txQueued = 0;
     }
-  else
-    post("ERROR: not enough arguments to joinSeq");
+}
+
+// end: apply the queued edits, then regroup each touched slot and variation once
+void polyMath_tilde_end(t_polyMath_tilde *x)
+{
+  t_int i, n, k, slot, var, queued;
+  t_symbol *sel;
+  if(!x->txOpen)
+    {
+      post("end: no transaction open");
+      return;
+    }
+  queued = x->txQueued;
+  x->txOpen = 0;
+  x->undoStep++;
+  x->txApplying = 1;
+  x->txRegroups = 0;
+  for(i = 0; i < SLOTS * (VARIATIONS + 1); i++) x->txFrom[i] = -1;
+  for(i = 0; i < x->txLen; i += n + 2)
+    {
+      sel = atom_getsymbol(&x->txBuf[i]);
+      n = (t_int)atom_getfloat(&x->txBuf[i + 1]);
+      if(sel == gensym("pSet")) polyMath_tilde_setP(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("pSetOnly")) polyMath_tilde_setPOnly(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("vSetOnly")) polyMath_tilde_setVOnly(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("pSetRange")) polyMath_tilde_pSetRange(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("pSetLane")) polyMath_tilde_pSetLane(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("seqUnit")) polyMath_tilde_seqInSlot(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("makeJoin")) polyMath_tilde_makeJoin(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("swap")) polyMath_tilde_swapElement(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("insertGroup")) polyMath_tilde_insertGroup(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("deleteGroup")) polyMath_tilde_deleteGroup(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("nest")) polyMath_tilde_nest(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("unnest")) polyMath_tilde_unnest(x, sel, n, x->txBuf + i + 2);
+      else if(sel == gensym("setJoins")) polyMath_tilde_joinSeq(x, sel, n, x->txBuf + i + 2);
+    }
+  for(i = 0; i < x->txRegroups; i++)
+    {
+      slot = x->txList[i] % SLOTS;
+      var = x->txList[i] / SLOTS;
+      k = regroupFrom(x, slot, var, x->txFrom[x->txList[i]], x->txTo[x->txList[i]]);
+      markDirty(x, slot, var, -1, x->txFrom[x->txList[i]], k - 1);
+    }
+  x->txApplying = 0;
+  x->txLen = x->txQueued = x->txRegroups = 0;
+  if(x->notifyChanges && x->dirtyCount) clock_delay(x->changeOut, 0);
+  if(x->myBug == 9) post("end: %d edits applied", queued);
 }
 
 void polyMath_tilde_initSlot(t_polyMath_tilde *x, t_floatarg f)
@@ -3854,6 +5830,7 @@ void polyMath_tilde_initSlot(t_polyMath_tilde *x, t_floatarg f)
       SETFLOAT(&x->seq.eAcc8[x->initSlot * MAXSEQ + x->l],0);
       SETFLOAT(&x->seq.pAcc8[x->initSlot * MAXSEQ + x->l],0);
     }
+  markDirty(x, x->initSlot, 0, -1, 0, MAXSEQ - 1);
 }
 
 /* perform function should be able to connect joins together
@@ -3968,6 +5945,7 @@ void polyMath_tilde_init(t_polyMath_tilde *x, t_symbol *s)
 	  SETFLOAT(&x->seq.eSizeInv[x->a * x->b],0);
 	}
     }
+  for(x->a = 0; x->a < SLOTS; x->a++) joinResolve(x, x->a, 0);
   x->Pthis = 0.0625;
   x->PJoin = 1;
   x->PStep = 0;
@@ -3976,8 +5954,51 @@ void polyMath_tilde_init(t_polyMath_tilde *x, t_symbol *s)
   x->barNew = 0;
 }
 
+// output one page of a sequence: a dType 97 header, then the values as a normal dType list
+t_int getSeqPage(t_polyMath_tilde *x, t_int slot, t_int var, t_int field, t_int start, t_int count)
+{
+  t_atom *fieldArray = seqFieldArray(x, var > 0, field);
+  t_int seqOffset = var > 0 ? slot * MAXSEQ + (var - 1) * x->SEQSIZE : slot * MAXSEQ;
+  t_int arraySize = var > 0 ? x->VARSIZE : x->SEQSIZE;
+  t_int len = var > 0 ? x->var.len[slot + (var - 1) * SLOTS] : x->seq.len[slot];
+  t_int i;
+  if(fieldArray == 0)
+    {
+      post("That sequence output is undefined (yet!");
+      outlet_float(x->dType,-2);
+      return(0);
+    }
+  if(len < 1)
+    {
+      post("This slot has not been filled yet!");
+      outlet_float(x->dType,-1);
+      return(0);
+    }
+  start = start < 0 ? 0 : start > len ? len : start;
+  count = count < 0 ? 0 : start + count > len ? len - start : count;
+  SETFLOAT(&x->dumpHead[0], (t_float)slot);
+  SETFLOAT(&x->dumpHead[1], (t_float)var);
+  SETFLOAT(&x->dumpHead[2], (t_float)field);
+  SETFLOAT(&x->dumpHead[3], (t_float)start);
+  SETFLOAT(&x->dumpHead[4], (t_float)count);
+  SETFLOAT(&x->dumpHead[5], (t_float)len);
+  outlet_float(x->dType,97);
+  outlet_list(x->dataOut, gensym("list"), 6, x->dumpHead);
+  if(count > 0)
+    {
+      for(i = 0; i < count; i++)
+	{
+	  SETFLOAT(&x->outList[i],atom_getfloatarg(seqOffset + start + i, arraySize, fieldArray));
+	}
+      outlet_float(x->dType,(t_float)field);
+      outlet_list(x->dataOut, gensym("list"), count, x->outList);
+    }
+  return(count);
+}
+
 void polyMath_tilde_getSeq(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
 {
+  if(x->grpFixCount) polyMath_tilde_groupFix(x);
   if(argc == 3)
     {
       // slot, variation, dType
@@ -4567,12 +6588,98 @@ void polyMath_tilde_getSeq(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom
 	  post("Slot must be from 0 to %d",SLOTS - 1);
 	}
     }
+  else if(argc == 5)
+    {
+      // slot, variation, dType, start, count - one page of a long sequence
+      x->getSlot = atom_getfloat(argv);
+      x->getVar = atom_getfloat(argv+1);
+      x->getPar = atom_getfloat(argv+2);
+      if(x->getSlot < 0 || x->getSlot >= SLOTS) post("Slot must be from 0 to %d",SLOTS - 1);
+      else if(x->getVar < 0 || x->getVar > VARIATIONS) post("Variation must be 0, or 1 to %d",VARIATIONS);
+      else getSeqPage(x, x->getSlot, x->getVar, x->getPar, (t_int)atom_getfloat(argv+3), (t_int)atom_getfloat(argv+4));
+    }
   else if(argc == 1)
     {
       
     }
 }
 
+// streamed getSequence: one page per scheduler tick, so that a long dump never holds up the audio
+void polyMath_tilde_seqDump(t_polyMath_tilde *x)
+{
+  t_int sent = getSeqPage(x, x->dumpSlot, x->dumpVar, x->dumpPar, x->dumpStart, x->dumpPage);
+  x->dumpStart += sent;
+  if(sent > 0 && x->dumpStart < x->dumpLen) clock_delay(x->seqDump, 64);
+}
+
+void polyMath_tilde_streamSeq(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  if(argc == 3 || argc == 4)
+    {
+      // slot, variation, dType (, page size)
+      x->dumpSlot = (t_int)atom_getfloat(argv);
+      x->dumpVar = (t_int)atom_getfloat(argv+1);
+      x->dumpPar = (t_int)atom_getfloat(argv+2);
+      x->dumpPage = argc == 4 ? (t_int)atom_getfloat(argv+3) : 64;
+      x->dumpPage = x->dumpPage < 1 ? 1 : x->dumpPage > MAXSEQ ? MAXSEQ : x->dumpPage;
+      if(x->dumpSlot < 0 || x->dumpSlot >= SLOTS) post("Slot must be from 0 to %d",SLOTS - 1);
+      else if(x->dumpVar < 0 || x->dumpVar > VARIATIONS) post("Variation must be 0, or 1 to %d",VARIATIONS);
+      else
+	{
+	  x->dumpLen = x->dumpVar > 0 ? x->var.len[x->dumpSlot + (x->dumpVar - 1) * SLOTS] : x->seq.len[x->dumpSlot];
+	  x->dumpStart = 0;
+	  clock_unset(x->seqDump);
+	  polyMath_tilde_seqDump(x);
+	}
+    }
+  else post("streamSequence takes slot, variation, dType and optionally page size");
+}
+
+// output "changed slot var dType start end" for every logged range, then clear the log
+// withData follows each range with its values as a paged list (see getSeqPage)
+static void flushChanges(t_polyMath_tilde *x, t_int withData)
+{
+  t_int i, field, dirty;
+  for(i = 0; i < x->dirtyCount; i++)
+    {
+      dirty = x->dirtyList[i];
+      for(field = 0; field < 27; field++)
+	{
+	  if(dirtyBit(field) & x->dirtyFields[dirty])
+	    {
+	      SETFLOAT(&x->changeList[0], (t_float)(dirty % SLOTS));
+	      SETFLOAT(&x->changeList[1], (t_float)(dirty / SLOTS));
+	      SETFLOAT(&x->changeList[2], (t_float)field);
+	      SETFLOAT(&x->changeList[3], (t_float)x->dirtyStart[dirty]);
+	      SETFLOAT(&x->changeList[4], (t_float)x->dirtyEnd[dirty]);
+	      outlet_float(x->dType, 90);
+	      outlet_anything(x->dataOut, gensym("changed"), 5, x->changeList);
+	      if(withData) getSeqPage(x, dirty % SLOTS, dirty / SLOTS, field, x->dirtyStart[dirty], x->dirtyEnd[dirty] - x->dirtyStart[dirty] + 1);
+	    }
+	}
+      x->dirtyFields[dirty] = 0;
+    }
+  x->dirtyCount = 0;
+}
+
+void polyMath_tilde_changeOut(t_polyMath_tilde *x)
+{
+  flushChanges(x, 0);
+}
+
+// on request: changed ranges and their values, whether or not notifyChanges is on
+void polyMath_tilde_getChanges(t_polyMath_tilde *x)
+{
+  clock_unset(x->changeOut);
+  flushChanges(x, 1);
+}
+
+void polyMath_tilde_notifyChanges(t_polyMath_tilde *x, t_floatarg f)
+{
+  x->notifyChanges = f != 0 ? 1 : 0;
+  if(x->notifyChanges && x->dirtyCount) clock_delay(x->changeOut, 0);
+}
+
 // DEBUG CODE
 void polyMath_tilde_debug(t_polyMath_tilde *x, t_floatarg myBug)
 {
@@ -4758,81 +6865,343 @@ void polyMath_tilde_debug(t_polyMath_tilde *x, t_floatarg myBug)
 }
 
 // JOIN ROUTINES
-static void checkJoinsOut(t_polyMath_tilde *x)
+/* GENERATIVE PLAYBACK
+ * generate slot mode: the base sequence of the slot is not played in order but one event (join run) at a time,
+ * picked while playing - shuffled without replacement every cycle (mode 1) or by a Markov chain over the
+ * events (mode 2, weights set with genWeights, uniform otherwise), or whole groups in the order of a group map
+ * (mode 3, set with groupMap or permuteGroups). Nothing is written to the variation arrays, offsets are
+ * accumulated from the event sizes (or taken from the map's prefix sums). genCycle latches the mode (genCur)
+ * and genNext(x, 1) the run sizes, so changes take effect at the start of the next cycle. In modes 1 and 2 the runs always fill the cycle exactly: the Markov chain only draws runs
+ * that fit, and the last run is cut or padded to end on the cycle (genFitRun).
+ */
+static t_int genRun(t_polyMath_tilde *x, t_int step)
+{
+  t_int len = x->seq.len[x->slot];
+  t_int run = (t_int)atom_getfloatarg(x->slot * MAXSEQ + step, x->SEQSIZE, x->seq.eJoin);
+  run = run > 1 ? run : 1;
+  return(step + run > len ? len - step : run);
+}
+
+static void genShuffle(t_polyMath_tilde *x)
 {
-  if(x->PJoined > 1) // 2nd November - what's the deal with 1 instead of 0? 14th Nov 2019: This is an error, but we can live with it for now...
+  t_int i, j, tmp;
+  for(i = x->genBlocks - 1; i > 0; i--)
     {
-      x->PJoined--; // 3, 2, 1
-      x->jFirst = 0;
+      j = (t_int)(playRandom(x) * (double)(i + 1));
+      tmp = x->genOrder[i];
+      x->genOrder[i] = x->genOrder[j];
+      x->genOrder[j] = tmp;
     }
-  else
+}
+
+// Markov weight of block b, 0 if its run does not fit in what is left of the cycle
+static t_float genWeight(t_polyMath_tilde *x, t_float *row, t_int b)
+{
+  if(x->genBlockSize[x->genOrder[b]] > x->genLeft + x->sizeThreshold) return(0);
+  return(row ? row[x->genOrder[b]] : 1);
+}
+
+static t_int genMarkov(t_polyMath_tilde *x)
+{
+  t_int len = x->seq.len[x->slot];
+  t_float *row = x->genTable[x->slot] && x->genTableLen[x->slot] == len ? x->genTable[x->slot] + x->genStart * len : 0;
+  t_float sum = 0, r, w;
+  t_int b, last = 0;
+  for(b = 0; b < x->genBlocks; b++) sum += genWeight(x, row, b);
+  if(sum <= 0) return(x->genEnd < len ? x->genEnd : 0); // nothing fits: the next run in order, cut by genFitRun
+  r = playRandom(x) * sum;
+  for(b = 0; b < x->genBlocks; b++)
     {
-      if(x->PJoin == 1)
-	{
-	  if(x->jFlag > 0)
-	    {
-	      x->jFlag = 0;
-	      x->JESize = x->PESize;
-	      x->JPESI = x->PESInv;
-	      if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
-	    }
-	  else
-	    { // normal step
-	      x->JESize = x->PESize;
-	      x->JPESI = x->PESInv;
-	      if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
-	    }
-	}
-      else
+      if((w = genWeight(x, row, b)) <= 0) continue;
+      last = b;
+      r -= w;
+      if(r < 0) break;
+    }
+  return(x->genOrder[last]);
+}
+
+/* the run from genStart is about to play: if it reaches past the end of the cycle it is cut there, and if
+ * no run fits in what it leaves, its last event is padded to the end of the cycle
+ */
+static void genFitRun(t_polyMath_tilde *x)
+{
+  t_float size = 0, e, left;
+  t_int q;
+  x->genFitStep = -1;
+  for(q = x->genStart; q < x->genEnd; q++)
+    {
+      e = atom_getfloatarg(x->slot * MAXSEQ + q, x->SEQSIZE, x->seq.eSize);
+      if(size + e >= x->genLeft - x->sizeThreshold)
 	{
-	  x->jFirst = 1;
-	  x->JoinVal = (t_int)x->PJoin;
-	  x->PJoined = x->JoinVal;
-	  x->JESize = x->PESize * x->PJoin;
-	  x->JPESI = x->PESInv / x->PJoin;
-	  if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
+	  x->genFitStep = q;
+	  x->genFitSize = x->genLeft - size;
+	  x->genEnd = q + 1;
+	  x->genRunSize = x->genLeft;
+	  x->genLeft = 0;
+	  return;
 	}
+      size += e;
+    }
+  left = x->genLeft - size;
+  if(x->genMinSize > left + x->sizeThreshold)
+    {
+      x->genFitStep = x->genEnd - 1;
+      x->genFitSize = atom_getfloatarg(x->slot * MAXSEQ + x->genFitStep, x->SEQSIZE, x->seq.eSize) + left;
+      size += left;
+      left = 0;
     }
+  x->genRunSize = size;
+  x->genLeft = left;
 }
 
-static void checkJoinsVarOut(t_polyMath_tilde *x)
+// events in group g of the base sequence of slot
+// group map: groups are played whole, in map order, at their prefix-sum offset
+static void genGroupNext(t_polyMath_tilde *x, t_int restart)
 {
-  if(x->PJoined > 1)
+  t_int base = x->slot * GROUPS;
+  t_int g;
+  if(restart)
     {
-      x->PJoined--; // 3, 2, 1
-      x->jFirst = 0;
+      x->genBlock = 0;
+      x->genSrc = -1;
     }
+  else if(x->genSrc + 1 < x->genEnd) x->genSrc++;
   else
     {
-      if(x->PJoin == 1)
+      if(++x->genBlock >= x->grpMapN[x->slot]) x->genBlock = 0;
+      x->genSrc = -1;
+    }
+  g = x->grpMap[base + x->genBlock];
+  if(x->genSrc < 0)
+    {
+      x->genStart = x->genSrc = x->grp.gStart[base + g];
+      x->genEnd = x->genStart + grpEvents(x, x->slot, g);
+    }
+  x->PEOff = x->grpMapOff[base + x->genBlock] + atom_getfloatarg(x->slot * MAXSEQ + x->genSrc, x->SEQSIZE, x->seq.eOff)
+    - atom_getfloatarg(base + g, x->GROUPSIZE, x->grp.offset);
+}
+
+// pick the next event - restart: first event of a new cycle
+static void genNext(t_polyMath_tilde *x, t_int restart)
+{
+  t_int len = x->seq.len[x->slot];
+  t_int q;
+  t_float size;
+  if(x->genCur == 3)
+    {
+      genGroupNext(x, restart);
+      return;
+    }
+  if(restart)
+    {
+      x->genBlocks = 0;
+      x->genMinSize = (t_float)x->grp.cycles[x->slot] + 1;
+      for(q = 0; q < len; q++)
 	{
-	  x->eChanged = 0;
-	  if(x->jFlag > 0)
+	  size = atom_getfloatarg(x->slot * MAXSEQ + q, x->SEQSIZE, x->seq.eSize);
+	  if(q == 0 || q == x->genOrder[x->genBlocks - 1] + genRun(x, x->genOrder[x->genBlocks - 1]))
 	    {
-	      x->jFlag = 0;
-	      x->JESize = x->PESize;
-	      x->VPESI = 1 / x->PESize;
-	      if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
-	    }
-	  else
-	    { // normal step
-	      x->JESize = x->PESize;
-	      x->VPESI = 1 /x->PESize;
-	      if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
+	      x->genOrder[x->genBlocks++] = q;
+	      x->genBlockSize[q] = size;
 	    }
+	  else x->genBlockSize[x->genOrder[x->genBlocks - 1]] += size;
+	}
+      for(q = 0; q < x->genBlocks; q++)
+	if(x->genBlockSize[x->genOrder[q]] < x->genMinSize) x->genMinSize = x->genBlockSize[x->genOrder[q]];
+      x->genBlock = 0;
+      x->genLeft = (t_float)x->grp.cycles[x->slot];
+      if(x->genCur == 1)
+	{
+	  genShuffle(x);
+	  x->genStart = x->genOrder[0];
+	}
+      else x->genStart = 0;
+      x->PEOff = 0;
+    }
+  else if(x->genSrc + 1 < x->genEnd)
+    {
+      x->genSrc++;
+      return;
+    }
+  else if(x->genCur == 1)
+    {
+      if(++x->genBlock >= x->genBlocks)
+	{
+	  genShuffle(x);
+	  x->genBlock = 0;
 	}
-      else // Joined event
+      x->genStart = x->genOrder[x->genBlock];
+    }
+  else x->genStart = genMarkov(x);
+  x->genSrc = x->genStart;
+  x->genEnd = x->genStart + genRun(x, x->genStart);
+  genFitRun(x);
+}
+
+// start of a cycle of the playing slot
+static void genCycle(t_polyMath_tilde *x)
+{
+  x->genCur = x->genMode[x->slot];
+  if(x->genCur == 0 || x->seq.len[x->slot] < 1) x->genSlot = -1;
+  else if(x->genCur == 3 && x->grpMapN[x->slot] != x->grp.nGroups[x->slot]) x->genSlot = -1; // regrouped since
+  else
+    {
+      x->genSlot = x->slot;
+      genNext(x, 1);
+    }
+}
+
+// next event of the cycle, in place of x->PStep++ and the written offset
+static void genStep(t_polyMath_tilde *x)
+{
+  x->PStep++;
+  x->PEOff += x->PESize;
+  genNext(x, 0);
+}
+
+void polyMath_tilde_generate(t_polyMath_tilde *x, t_floatarg fSlot, t_floatarg fMode)
+{
+  t_int slot = (t_int)fSlot;
+  t_int mode = (t_int)fMode;
+  if(slot < 0 || slot >= SLOTS || mode < 0 || mode > 3) post("generate takes a slot (0 - %d) and a mode: 0 = off, 1 = shuffle, 2 = Markov, 3 = group map", SLOTS - 1);
+  else if(mode == 3 && x->grpMapN[slot] == 0) post("generate: slot %d has no group map - use groupMap or permuteGroups", slot);
+  else x->genMode[slot] = mode;
+}
+
+// genWeights slot fromStep w0 w1 ... : Markov weights from one event to each event of the slot
+void polyMath_tilde_genWeights(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, from, len, i;
+  if(argc < 3)
+    {
+      post("genWeights takes a slot, a step and a list of weights");
+      return;
+    }
+  slot = (t_int)atom_getfloat(argv);
+  from = (t_int)atom_getfloat(argv+1);
+  len = slot >= 0 && slot < SLOTS ? x->seq.len[slot] : 0;
+  if(from < 0 || from >= len)
+    {
+      post("genWeights: no step %d in slot %d", from, slot);
+      return;
+    }
+  if(x->genTableLen[slot] != len)
+    {
+      if(x->genTableLen[slot]) freebytes(x->genTable[slot], x->genTableLen[slot] * x->genTableLen[slot] * sizeof(t_float));
+      x->genTable[slot] = (t_float *)getbytes(len * len * sizeof(t_float));
+      x->genTableLen[slot] = x->genTable[slot] ? len : 0;
+      if(x->genTable[slot] == 0) return;
+      for(i = 0; i < len * len; i++) x->genTable[slot][i] = 1;
+    }
+  for(i = 0; i < argc - 2 && i < len; i++) x->genTable[slot][from * len + i] = atom_getfloat(argv + 2 + i) > 0 ? atom_getfloat(argv + 2 + i) : 0;
+}
+
+// one pass over the map
+static void groupMapOffsets(t_polyMath_tilde *x, t_int slot)
+{
+  t_int base = slot * GROUPS;
+  t_int k;
+  t_float off = atom_getfloatarg(base, x->GROUPSIZE, x->grp.offset);
+  for(k = 0; k < x->grpMapN[slot]; k++)
+    {
+      x->grpMapOff[base + k] = off;
+      off += atom_getfloatarg(base + x->grpMap[base + k], x->GROUPSIZE, x->grp.size);
+    }
+}
+
+// groupMap slot g0 g1 ... : play the groups of the slot in this order (every group exactly once)
+void polyMath_tilde_groupMap(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int seen[GROUPS];
+  t_int slot, nGroups, k, g;
+  slot = argc > 0 ? (t_int)atom_getfloat(argv) : -1;
+  if(slot < 0 || slot >= SLOTS)
+    {
+      post("groupMap takes a slot and the order of its groups");
+      return;
+    }
+  if(x->grpFixGroup[slot] >= 0) groupFixSlot(x, slot);
+  nGroups = x->grp.nGroups[slot];
+  if(argc - 1 != nGroups)
+    {
+      post("groupMap: slot %d has %d groups, %d given", slot, nGroups, argc - 1);
+      return;
+    }
+  for(g = 0; g < nGroups; g++) seen[g] = 0;
+  for(k = 0; k < nGroups; k++)
+    {
+      g = (t_int)atom_getfloat(argv + 1 + k);
+      if(g < 0 || g >= nGroups || seen[g]++)
 	{
-	  x->eChanged = 0;
-	  x->jFirst = 1;
-	  x->JoinVal = (t_int)x->PJoin;
-	  x->PJoined = x->JoinVal;
-	  x->JESize = x->PESize * x->PJoin;
-	  x->VPESI = 1 / x->JESize; // perhaps it's time to use the jSize array in var?
-	  x->jFlag = 1;
-	  if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
+	  post("groupMap: every group from 0 to %d must appear once", nGroups - 1);
+	  return;
 	}
     }
+  for(k = 0; k < nGroups; k++) x->grpMap[slot * GROUPS + k] = (t_int)atom_getfloat(argv + 1 + k);
+  x->grpMapN[slot] = nGroups;
+  groupMapOffsets(x, slot);
+  x->genMode[slot] = 3;
+}
+
+/* permuteGroups slot [amount [mode]]: draw a group map with the scrambleGroups modes (default 2, every group
+ * moves). Join runs that cross a group boundary keep their groups together.
+ */
+void polyMath_tilde_permuteGroups(t_polyMath_tilde *x, t_symbol *s, t_int argc, t_atom *argv)
+{
+  t_int slot, len, pos, src, end, g, k, mode;
+  t_float amount;
+  slot = argc > 0 ? (t_int)atom_getfloat(argv) : -1;
+  if(slot >= 0 && slot < SLOTS && x->grpFixGroup[slot] >= 0) groupFixSlot(x, slot);
+  if(slot < 0 || slot >= SLOTS || (len = x->seq.len[slot]) < 1 || x->grp.nGroups[slot] < 1)
+    {
+      post("permuteGroups takes a slot with a sequence [, amount [, mode]]");
+      return;
+    }
+  amount = argc > 1 ? atom_getfloat(argv+1) : 1;
+  mode = argc > 2 ? (t_int)atom_getfloat(argv+2) : argc > 1 ? 0 : 2;
+  mode = mode < 0 ? 0 : mode > 2 ? 2 : mode;
+  if(mode == 0) amount = (amount < 0 ? 0 : amount > 1 ? 1 : amount) * 0.5;
+  if(!scrambleSwaps(x, slot, len, amount, mode, 1, 0)) return;
+  // block order -> group order
+  k = 0;
+  for(pos = 0, end = 0; end < len; pos++)
+    {
+      src = x->vGrp.blockOrder[pos];
+      g = (t_int)atom_getfloatarg(slot * MAXSEQ + x->vGrp.blockStart[src], x->SEQSIZE, x->seq.groupNum);
+      for(; g < x->grp.nGroups[slot] && x->grp.gStart[slot * GROUPS + g] < x->vGrp.blockStart[src] + x->vGrp.blockLen[src]; g++)
+	x->grpMap[slot * GROUPS + k++] = g;
+      end += x->vGrp.blockLen[src];
+    }
+  x->grpMapN[slot] = k;
+  groupMapOffsets(x, slot);
+  x->genMode[slot] = 3;
+}
+
+// joins are looked up in the resolved cache (see JOIN CACHE): a run start sounds for the whole run, the
+// events inside it are silent and keep the phase increment of the run
+static void checkJoinsOut(t_polyMath_tilde *x)
+{
+  x->jFlag = 0;
+  x->PJoined = x->PJRun > 0 ? x->PJRun : 0;
+  x->jFirst = x->PJRun > 1;
+  if(x->PJRun < 0) return;
+  x->JoinVal = x->PJRun > 0 ? x->PJRun : 1;
+  x->JESize = x->PJRun > 0 ? x->PJSize : x->PESize;
+  x->JPESI = x->JESize > 0 ? 1 / x->JESize : x->PESInv;
+  if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
+}
+
+static void checkJoinsVarOut(t_polyMath_tilde *x)
+{
+  x->eChanged = 0;
+  x->jFlag = 0;
+  x->PJoined = x->PJRun > 0 ? x->PJRun : 0;
+  x->jFirst = x->PJRun > 1;
+  if(x->PJRun < 0) return;
+  x->JoinVal = x->PJRun > 0 ? x->PJRun : 1;
+  x->JESize = x->PJRun > 0 ? x->PJSize : x->PESize;
+  x->VPESI = x->JESize > 0 ? 1 / x->JESize : x->PESInv;
+  if(x->JESize > x->sizeThreshold) clock_delay(x->fOut,0L);
 }
 
 void polyMath_tilde_setBpm(t_polyMath_tilde *x, t_floatarg f)
@@ -4846,6 +7215,41 @@ void polyMath_tilde_setBpm(t_polyMath_tilde *x, t_floatarg f)
   else post("bpm must be a positive number!");
 }
 
+// write the held accent values of the current event into the -sig outlets
+static void sigLanesOut(t_polyMath_tilde *x, t_int smp)
+{
+  switch(x->nLanes) // lanes nLanes..1
+    {
+    case(8): x->sigP[7][smp] = x->Pacc8;
+      /* fallthrough */
+    case(7): x->sigP[6][smp] = x->Pacc7;
+      /* fallthrough */
+    case(6): x->sigP[5][smp] = x->Pacc6;
+      /* fallthrough */
+    case(5): x->sigP[4][smp] = x->Pacc5;
+      /* fallthrough */
+    case(4): x->sigP[3][smp] = x->Pacc4;
+      /* fallthrough */
+    case(3): x->sigP[2][smp] = x->Pacc3;
+      /* fallthrough */
+    case(2): x->sigP[1][smp] = x->Pacc2;
+      /* fallthrough */
+    case(1): x->sigP[0][smp] = x->Pacc1;
+    default: break;
+    }
+  if(x->sigLanes == 1)
+    {
+      x->sigE[0][smp] = x->E_Acc1;
+      x->sigE[1][smp] = x->E_Acc2;
+      x->sigE[2][smp] = x->E_Acc3;
+      x->sigE[3][smp] = x->E_Acc4;
+      x->sigE[4][smp] = x->E_Acc5;
+      x->sigE[5][smp] = x->E_Acc6;
+      x->sigE[6][smp] = x->E_Acc7;
+      x->sigE[7][smp] = x->E_Acc8;
+    }
+}
+
 // PERFORM ROUTINE
 //13th Jan 2018 - a better idea: while(n--) { if(x->changeFlag) {...} else { (the normal slot or var routines) }
 t_int *polyMath_tilde_perform(t_int *w)
@@ -4856,6 +7260,7 @@ t_int *polyMath_tilde_perform(t_int *w)
   t_float *alt3       = (t_float *)(w[4]);
   t_float *offset     = (t_float *)(w[5]);
   int n               = (int)(w[6]);
+  t_int smp = 0;
   if(x->firstStart == 1)
     {
       getVariables(x);
@@ -4870,6 +7275,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 	  *out3++ = *in++;
 	  *alt3++ = 0;
 	  *offset++ = 0;
+	  if(x->sigLanes) sigLanesOut(x, smp++);
 	}
     }
   else while(n--)
@@ -4889,6 +7295,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ, x->SEQSIZE, x->seq.eOff);
 		  //x->pageNum = 0;
 		  //x->pageFlag = 1;
+		  genCycle(x);
 		  getVariables(x);
 		  x->scrambling = 0;
 		  checkJoinsOut(x);
@@ -4904,6 +7311,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ, x->SEQSIZE, x->seq.eOff);
 		  //x->pageNum = 0;
 		  //x->pageFlag = 1;
+		  genCycle(x);
 		  getVariables(x);
 		  x->scrambling = 0;
 		  checkJoinsOut(x);
@@ -4933,6 +7341,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 			  x->slot = x->nextSlot;
 			  x->PGcyc -= x->wrapSubVal;
 			  x->PStep = x->NStep;
+			  x->genSlot = -1;
 			  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
 			  getVariables(x);
 			  checkJoinsOut(x);
@@ -4947,6 +7356,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 			  x->slot = x->nextSlot;
 			  x->PGcyc -= x->wrapSubVal;
 			  x->PStep = x->NStep;
+			  x->genSlot = -1;
 			  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.eOff);
 			  x->VOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.varOff);
 			  getVariations(x);
@@ -4960,8 +7370,17 @@ t_int *polyMath_tilde_perform(t_int *w)
 		      x->eChanged = 0;
 		      if(x->altOut) x->altNum = !x->altNum;
 		      //START November 2nd version 
-		      x->PStep++;
-		      x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
+		      if(x->genSlot == x->slot) genStep(x);
+		      else if(x->grp.gType[x->slot])
+			{
+			  x->PStep = onsetFind(x, x->slot, x->InVal + x->PGcyc);
+			  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
+			}
+		      else
+			{
+			  x->PStep++;
+			  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
+			}
 		      if(x->myBug == 7) post("PEOff = %f",x->PEOff);
 		      getVariables(x);
 		      checkJoinsOut(x);
@@ -4974,10 +7393,6 @@ t_int *polyMath_tilde_perform(t_int *w)
 		  x->PGcyc = 0;
 		  x->PEOff = 0;
 		  x->PStep = 0;
-		  x->PJoined = 0;
-		  x->JoinVal = 1; // just in case...but beware the potential source of a bug!
-		  x->jFlag = 0;
-		  x->jFirst = 0;
                   if(x->jumpSlotAtEnd)
 		    {
 		      x->slot = x->nextSlot;
@@ -4985,6 +7400,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		      x->barNew = 1;
 		      if(x->altOut) x->altNum = !x->altNum;
 		      x->scrambling = 0;
+		      genCycle(x);
 		      getVariables(x);
 		      checkJoinsOut(x);
 		    }
@@ -5004,6 +7420,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		    {
 		      x->barNew = 1;
 		      if(x->altOut) x->altNum = !x->altNum;
+		      genCycle(x);
 		      getVariables(x);
 		      checkJoinsOut(x);
 		    }
@@ -5017,6 +7434,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		    x->slot = x->nextSlot;
 		    x->PGcyc -= x->wrapSubVal;
 		    x->PStep = x->NStep;
+		    x->genSlot = -1;
 		    x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
 		    getVariables(x);
 		    checkJoinsOut(x);
@@ -5031,6 +7449,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		    x->slot = x->nextSlot;
 		    x->PGcyc -= x->wrapSubVal;
 		    x->PStep = x->NStep;
+		    x->genSlot = -1;
 		    x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.eOff);
 		    x->VOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.varOff);
 		    getVariations(x);
@@ -5042,8 +7461,17 @@ t_int *polyMath_tilde_perform(t_int *w)
 	    else if(x->InVal + x->PGcyc >= x->PEOff + x->PESize)
 	      { //START November 2nd version
 		    //x->instant = x->InVal; // added Jan 6th 2018
-		x->PStep++;
-		x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
+		if(x->genSlot == x->slot) genStep(x);
+		else if(x->grp.gType[x->slot])
+		  {
+		    x->PStep = onsetFind(x, x->slot, x->InVal + x->PGcyc);
+		    x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
+		  }
+		else
+		  {
+		    x->PStep++;
+		    x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
+		  }
 		if(x->myBug == 7) post("PEOff = %f",x->PEOff);
 		getVariables(x);
 		if(x->altOut) x->altNum = !x->altNum;
@@ -5075,6 +7503,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		  x->PGcyc = 0;
 		  x->zeroNextSlot = 0;
 		  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ, x->SEQSIZE, x->seq.eOff);
+		  genCycle(x);
 		  getVariables(x);
 		  checkJoinsOut(x);
 		  x->scrambling = 0;
@@ -5096,10 +7525,6 @@ t_int *polyMath_tilde_perform(t_int *w)
 		{ // reset to 0
 		  x->PStep = 0;
 		  x->PGcyc = 0;
-		  x->PJoined = 0;
-		  x->JoinVal = 1; // just in case...but beware the potential source of a bug!
-		  x->jFlag = 0;
-		  x->jFirst = 0;
                   if(x->jumpSlotAtEnd)
 		    {
 		      x->slot = x->nextSlot;
@@ -5108,6 +7533,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		      if(x->altOut) x->altNum = !x->altNum;
 		      x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf + x->SEQSIZE, x->VARSIZE, x->var.eOff);
 		      x->scrambling = 0;
+		      genCycle(x);
 		      getVariables(x);
 		      checkJoinsOut(x);
 		    }
@@ -5143,6 +7569,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 			  x->slot = x->nextSlot;
 			  x->PGcyc -= x->wrapSubVal;
 			  x->PStep = x->NStep;
+			  x->genSlot = -1;
 			  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
 			  getVariables(x);
 			  checkJoinsOut(x);
@@ -5157,6 +7584,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 			  x->slot = x->nextSlot;
 			  x->PGcyc -= x->wrapSubVal;
 			  x->PStep = x->NStep;
+			  x->genSlot = -1;
 			  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.eOff);
 			  x->VOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.varOff);
 			  getVariations(x);
@@ -5183,6 +7611,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		  x->slot = x->nextSlot;
 		  x->PGcyc -= x->wrapSubVal;
 		  x->PStep = x->NStep;
+		  x->genSlot = -1;
 		  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->PStep, x->SEQSIZE, x->seq.eOff);
 		  getVariables(x);
 		  checkJoinsOut(x);
@@ -5197,6 +7626,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 		  x->slot = x->nextSlot;
 		  x->PGcyc -= x->wrapSubVal;
 		  x->PStep = x->NStep;
+		  x->genSlot = -1;
 		  x->PEOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.eOff);
 		  x->VOff = atom_getfloatarg(x->slot * MAXSEQ + x->varPerf * x->SEQSIZE + x->PStep, x->VARSIZE, x->var.varOff);
 		  getVariations(x);
@@ -5285,6 +7715,7 @@ t_int *polyMath_tilde_perform(t_int *w)
 	    }
 	}
       *offset++ = x->PEOff;
+      if(x->sigLanes) sigLanesOut(x, smp++);
       x->PreVal = x->InVal;
       if((t_int)x->TotVal != x->pageNum)
 	{
@@ -5297,16 +7728,73 @@ t_int *polyMath_tilde_perform(t_int *w)
 
 void polyMath_tilde_dsp(t_polyMath_tilde *x, t_signal **sp)
 {
+  t_int i;
+#ifdef CLASS_MULTICHANNEL
+  t_sample *mc;
+  t_int n = sp[0]->s_n;
+  if(x->sigLanes == 2)
+    {
+      // channels: ramp, alt, offset, p1..pN - each n samples long
+      signal_setmultiout(&sp[1], 3 + x->nLanes);
+      mc = sp[1]->s_vec;
+      for(i = 0; i < x->nLanes; i++) x->sigP[i] = mc + (3 + i) * n;
+      dsp_add(polyMath_tilde_perform, 6, x, sp[0]->s_vec, mc, mc + n, mc + 2 * n, n);
+      return;
+    }
+  for(i = 1; i < (x->sigLanes ? 20 : 4); i++) signal_setmultiout(&sp[i], 1);
+#endif
+  if(x->sigLanes)
+    {
+      for(i = 0; i < 8; i++)
+	{
+	  x->sigP[i] = sp[4 + i * 2]->s_vec;
+	  x->sigE[i] = sp[5 + i * 2]->s_vec;
+	}
+    }
   dsp_add(polyMath_tilde_perform, 6, x, sp[0]->s_vec, sp[1]->s_vec, sp[2]->s_vec, sp[3]->s_vec, sp[0]->s_n);
 }
 
-static void *polyMath_tilde_new()
+static void *polyMath_tilde_new(t_symbol *s, int argc, t_atom *argv)
 {
   t_polyMath_tilde *x = (t_polyMath_tilde *)pd_new(polyMath_tilde_class);
+  t_int i;
+  x->sigLanes = 0;
+  x->nLanes = 0;
+  for(i = 0; i < argc; i++)
+    {
+      if(atom_getsymbolarg(i, argc, argv) == gensym("-sig"))
+	{
+	  if(x->sigLanes != 2)
+	    {
+	      x->sigLanes = 1;
+	      x->nLanes = 8;
+	    }
+	}
+      else if(atom_getsymbolarg(i, argc, argv) == gensym("-mc"))
+	{
+#ifdef CLASS_MULTICHANNEL
+	  x->sigLanes = 2;
+	  x->nLanes = 8;
+	  if(i + 1 < argc && (argv + i + 1)->a_type == A_FLOAT)
+	    {
+	      i++;
+	      x->nLanes = (t_int)atom_getfloat(argv + i);
+	      x->nLanes = x->nLanes < 0 ? 0 : x->nLanes > 8 ? 8 : x->nLanes;
+	    }
+#else
+	  post("polyMath~: -mc needs Pd 0.54 or later, using separate outlets");
+	  if(i + 1 < argc && (argv + i + 1)->a_type == A_FLOAT) i++; // the lane count
+#endif
+	}
+      else post("polyMath~: unknown creation argument");
+    }
   
   outlet_new(&x->x_obj, gensym("signal"));
-  outlet_new(&x->x_obj, gensym("signal"));
-  outlet_new(&x->x_obj, gensym("signal"));
+  if(x->sigLanes != 2)
+    {
+      outlet_new(&x->x_obj, gensym("signal"));
+      outlet_new(&x->x_obj, gensym("signal"));
+    }
 
   x->clock = outlet_new(&x->x_obj, &s_float);
   x->subclock = outlet_new(&x->x_obj, &s_float);
@@ -5335,6 +7823,10 @@ static void *polyMath_tilde_new()
   //*durFirst, *durAlt;
   x->durFirst = outlet_new(&x->x_obj, &s_list);
   x->durAlt = outlet_new(&x->x_obj, &s_list);
+  if(x->sigLanes == 1)
+    {
+      for(i = 0; i < 16; i++) outlet_new(&x->x_obj, gensym("signal"));
+    }
   // counters init:
   x->a = x->b = x->c = x->d = x->e = x->g = x->h = x->i = x->j = x->k = 0;// x->l = x->m = x->n = x->o = x->p = x->q = x->v = x->w = x->x = x->y = x->z = 0;
 
@@ -5386,14 +7878,8 @@ static void *polyMath_tilde_new()
   x->VARSIZE = VARIATIONS * x->SEQSIZE;
   x->VGROUPSIZE = VARIATIONS * x->GROUPSIZE;
   
-  unsigned short int seed1 = 12345;
-  unsigned short int seed2 = 28374;
   x->timeSeed = time(NULL);
-  x->timeSeed = x->timeSeed % 65536;
-  x->seed16v[2] = (unsigned short int)x->timeSeed;
-  x->seed16v[1] = seed2;
-  x->seed16v[0] = seed1;
-  seed48(x->seed16v);
+  seedRandom(x, (uint32_t)x->timeSeed ^ (uint32_t)(size_t)x);
 
   x->scramMeth = 0;
   x->scramSlot = 0;
@@ -5572,25 +8058,129 @@ static void *polyMath_tilde_new()
   x->fOut = clock_new(x, (t_method)polyMath_tilde_cout);
   x->early = clock_new(x, (t_method)polyMath_tilde_eChange);
   x->pageTurner = clock_new(x, (t_method)polyMath_tilde_pageTurn);
+  x->seqDump = clock_new(x, (t_method)polyMath_tilde_seqDump);
+  clock_setunit(x->seqDump, 1, 1); // delay in samples: 64 = the next scheduler tick
+  x->changeOut = clock_new(x, (t_method)polyMath_tilde_changeOut);
+  x->lookAhead = 0;
+  x->startTime = clock_getlogicaltime();
+  x->buildOut = clock_new(x, (t_method)polyMath_tilde_buildOut);
+  for(x->a = 0; x->a < SLOTS; x->a++)
+    {
+      x->pool[x->a] = 0;
+      x->poolSize[x->a] = 0;
+      x->poolStage[x->a] = 0;
+      x->poolStaged[x->a] = 0;
+      x->genMode[x->a] = 0;
+      x->genTable[x->a] = 0;
+      x->genTableLen[x->a] = 0;
+      x->grpMapN[x->a] = 0;
+      x->grpFixGroup[x->a] = -1;
+      x->grpFixEvent[x->a] = -1;
+      x->nest[x->a] = 0;
+      x->nestSize[x->a] = 0;
+    }
+  x->grpFixCount = 0;
+  x->joinCount = 0;
+  x->grpFix = clock_new(x, (t_method)polyMath_tilde_groupFix);
+  x->joinClock = clock_new(x, (t_method)polyMath_tilde_joinCache);
+  x->morphClock = clock_new(x, (t_method)polyMath_tilde_morphMask);
+  x->scramQHead = x->scramQCount = 0;
+  x->txOpen = x->txApplying = x->txLen = x->txSize = x->txQueued = x->txRegroups = 0;
+  x->txBuf = 0;
+  x->morphSlot = x->morphVar = x->morphOn = 0;
+  x->morphAmt = 0;
+  x->genSlot = -1;
+  x->genSrc = x->genStart = x->genEnd = x->genBlock = x->genBlocks = x->genCur = 0;
+  x->genMinSize = 0;
+  x->genFitStep = -1;
+  x->genLeft = x->genFitSize = x->genRunSize = 0;
+  x->buildBatch = x->batchOpen = x->batchPending = x->batchDone = x->batchOk = 0;
+  x->undoHead = x->undoCount = x->undoCur = x->undoStep = x->batchStep = 0;
+  x->undoBytes = 0;
+  x->undoMax = 4096 * 1024;
+  x->buildQuit = 0;
+  x->buildThreadOk = 0;
+  x->build = (t_varBuild *)getbytes(sizeof(t_varBuild));
+  if(x->build)
+    {
+      x->build->state = BUILD_IDLE;
+      pthread_mutex_init(&x->buildMutex, 0);
+      pthread_cond_init(&x->buildCond, 0);
+      x->buildThreadOk = pthread_create(&x->buildThread, 0, polyMath_tilde_buildThread, x) == 0;
+    }
+  if(!x->buildThreadOk) post("polyMath~: no worker thread - scramble will run in the scheduler");
+  x->dirtyCount = 0;
+  x->notifyChanges = 0;
+  for(x->a = 0; x->a < SLOTS * (VARIATIONS + 1); x->a++) x->dirtyFields[x->a] = 0;
   x->barNew = 0;
   getVariables(x);
   return (x);
 }
 
+static void polyMath_tilde_free(t_polyMath_tilde *x)
+{
+  undoClear(x);
+  if(x->buildThreadOk)
+    {
+      pthread_mutex_lock(&x->buildMutex);
+      x->buildQuit = 1;
+      pthread_cond_signal(&x->buildCond);
+      pthread_mutex_unlock(&x->buildMutex);
+      pthread_join(x->buildThread, 0);
+    }
+  if(x->build)
+    {
+      pthread_mutex_destroy(&x->buildMutex);
+      pthread_cond_destroy(&x->buildCond);
+      freebytes(x->build, sizeof(t_varBuild));
+    }
+  if(x->txSize) freebytes(x->txBuf, x->txSize * sizeof(t_atom));
+  for(x->a = 0; x->a < SLOTS; x->a++)
+    {
+      polyMath_tilde_varPool(x, (t_float)x->a, 0);
+      if(x->genTableLen[x->a]) freebytes(x->genTable[x->a], x->genTableLen[x->a] * x->genTableLen[x->a] * sizeof(t_float));
+      if(x->nestSize[x->a]) freebytes(x->nest[x->a], x->nestSize[x->a] * sizeof(t_nestNode));
+    }
+  clock_free(x->fOut);
+  clock_free(x->early);
+  clock_free(x->pageTurner);
+  clock_free(x->seqDump);
+  clock_free(x->changeOut);
+  clock_free(x->buildOut);
+  clock_free(x->grpFix);
+  clock_free(x->joinClock);
+  clock_free(x->morphClock);
+}
+
 void polyMath_tilde_setup(void)
 {
-  polyMath_tilde_class = class_new(gensym("polyMath~"), (t_newmethod)polyMath_tilde_new, 
-			      0, sizeof(t_polyMath_tilde), 0, A_GIMME, 0);
+  polyMath_tilde_class = class_new(gensym("polyMath~"), (t_newmethod)(void (*)(void))polyMath_tilde_new, 
+#ifdef CLASS_MULTICHANNEL
+			      (t_method)polyMath_tilde_free, sizeof(t_polyMath_tilde), CLASS_MULTICHANNEL, A_GIMME, 0);
+#else
+			      (t_method)polyMath_tilde_free, sizeof(t_polyMath_tilde), 0, A_GIMME, 0);
+#endif
     CLASS_MAINSIGNALIN(polyMath_tilde_class, t_polyMath_tilde, f);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_dsp, gensym("dsp"), 0);
 
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_init, gensym("init"), A_DEFFLOAT, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_slot, gensym("slot"), A_DEFFLOAT, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_setGroups, gensym("setGroups"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_insertGroup, gensym("insertGroup"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_deleteGroup, gensym("deleteGroup"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_nest, gensym("nest"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_unnest, gensym("unnest"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_addGroup, gensym("addGroup"), A_GIMME, 0);
 
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_groupInSlot, gensym("groupInSlot"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_groupThisSlot, gensym("groupThisSlot"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_onsetsInSlot, gensym("onsetsInSlot"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_quantize, gensym("quantize"), A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_concat, gensym("concat"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_interleave, gensym("interleave"), A_DEFFLOAT, A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_repeat, gensym("repeat"), A_DEFFLOAT, A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_euclid, gensym("euclid"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_additive, gensym("additive"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_thisSlot, gensym("thisSlot"), A_DEFFLOAT, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_jumpTo, gensym("jumpTo"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_jumpNext, gensym("jumpNext"), A_GIMME, 0);
@@ -5603,6 +8193,8 @@ void polyMath_tilde_setup(void)
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_setP, gensym("pSet"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_setPOnly, gensym("pSetOnly"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_setVOnly, gensym("vSetOnly"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_pSetRange, gensym("pSetRange"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_pSetLane, gensym("pSetLane"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_altOut, gensym("altOut"), A_DEFFLOAT, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_preOut, gensym("precent"), A_DEFFLOAT, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_eMult, gensym("eMult"), A_DEFFLOAT, 0);
@@ -5616,10 +8208,29 @@ void polyMath_tilde_setup(void)
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_swapElement, gensym("swap"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_seqInSlot, gensym("seqUnit"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_initSeqSlot, gensym("initSeqSlot"), A_DEFFLOAT, A_DEFFLOAT, 0);
-    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_groupScramble, gensym("scrambleGroups"), A_GIMME, 0); //not finished!
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_groupScramble, gensym("scrambleGroups"), A_GIMME, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_noRepeats, gensym("noRepeats"), A_DEFFLOAT, 0); //not finished!
 
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_getSeq, gensym("getSequence"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_streamSeq, gensym("streamSequence"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_notifyChanges, gensym("notifyChanges"), A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_getChanges, gensym("getChanges"), 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_lookahead, gensym("lookahead"), A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_seed, gensym("seed"), A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_scrambleAll, gensym("scrambleAll"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_begin, gensym("begin"), 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_end, gensym("end"), 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_undo, gensym("undo"), 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_redo, gensym("redo"), 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_undoMemory, gensym("undoMemory"), A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_morph, gensym("morph"), A_DEFFLOAT, A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_generate, gensym("generate"), A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_genWeights, gensym("genWeights"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_groupMap, gensym("groupMap"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_permuteGroups, gensym("permuteGroups"), A_GIMME, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_varPool, gensym("varPool"), A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_storeVar, gensym("storeVar"), A_DEFFLOAT, A_DEFFLOAT, A_DEFFLOAT, 0);
+    class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_freeVar, gensym("freeVar"), A_DEFFLOAT, A_DEFFLOAT, 0);
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_slotLen, gensym("slotLength"), A_GIMME, 0);
     
     class_addmethod(polyMath_tilde_class, (t_method)polyMath_tilde_setBpm, gensym("bpm"), A_DEFFLOAT, 0);